@@ -1,24 +1,43 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <termios.h>
 #include <signal.h>
 #include <time.h>
 #include <sys/select.h>
+#include "highscore.h"
+#include "rng.h"
+#include "perf_profile.h"
+#include "game_status.h"
+#include "block_patterns.h"
+#include "rt_mode.h"
+#include "render.h"
+#include "frame_ring.h"
 
 #define ROWS 15
 #define COLS 7
+#define SPAWN_THRESHOLD 26 // Out of 256: roughly a 10% chance per column
+#define FALL_DELAY 5       // Ticks between two block steps
+#define TICK_NS 100000000LL
 
 char grid[ROWS][COLS];
 int player_pos = COLS / 2;
 int blocks[COLS];
 int score = 0;
 int block_fall_delay = 0;
+int fall_delay = FALL_DELAY;
+uint8_t spawn_threshold = SPAWN_THRESHOLD;
+struct block_pattern pattern;
+struct rng rng;
 
 struct termios orig_termios;
+int terminal_restored = 0;
 
 // Reset terminal on exit
 void reset_terminal() {
+    if (terminal_restored) return; // Already done; clearing again would wipe the exit summary
+    terminal_restored = 1;
     tcsetattr(STDIN_FILENO, TCSANOW, &orig_termios);
     system("clear");
 }
@@ -27,6 +46,13 @@ void reset_terminal() {
 void handle_signal(int sig) {
     reset_terminal();
     printf("\nGame over! Your final score: %d\n", score);
+    printf("Seed: %llu (replay with --seed)\n", (unsigned long long)rng.seed);
+    int placed = hs_submit("avoid_blocks", score);
+    if (placed == 2) {
+        printf("New high score!\n");
+    } else if (placed == 1) {
+        printf("Made the top %d!\n", HS_TOP_K);
+    }
     exit(0);
 }
 
@@ -64,18 +90,16 @@ void initialize_grid() {
         blocks[j] = -1; // No blocks initially
     }
     grid[ROWS - 1][player_pos] = 'O'; // Player's initial position
+
+    // A block spawned now reaches the player's row after ROWS - 1 steps
+    pattern_init(&pattern, COLS, player_pos, fall_delay, ROWS - 1, spawn_threshold);
 }
 
 // Display grid
 void display_grid() {
-    system("clear");
-    for (int i = 0; i < ROWS; i++) {
-        for (int j = 0; j < COLS; j++) {
-            printf("%c ", grid[i][j]);
-        }
-        printf("\n");
-    }
-    printf("Score: %d\n", score);
+    char footer[32];
+    snprintf(footer, sizeof(footer), "Score: %d\n", score);
+    render_frame(&grid[0][0], ROWS, COLS, COLS, footer);
 }
 
 // Move the player left or right
@@ -89,10 +113,16 @@ void move_player(char direction) {
     grid[ROWS - 1][player_pos] = 'O';
 }
 
-// Spawn new blocks randomly at the top
+// Spawn new blocks randomly at the top, never closing off every path
 void spawn_blocks() {
+    uint64_t free = 0;
     for (int i = 0; i < COLS; i++) {
-        if (rand() % 10 == 0) { // 10% chance for a block to spawn in each column
+        if (blocks[i] == -1) free |= 1ULL << i;
+    }
+
+    uint64_t mask = pattern_next(&pattern, &rng, free); // The whole row from one draw
+    for (int i = 0; i < COLS; i++) {
+        if (mask & (1ULL << i)) {
             if (blocks[i] == -1) {
                 blocks[i] = 0;   // Mark block's initial row
                 grid[0][i] = '#'; // Place block at the top
@@ -101,8 +131,8 @@ void spawn_blocks() {
     }
 }
 
-// Update blocks' positions and check collisions
-void update_blocks() {
+// Update blocks' positions and check collisions; returns 1 if the player was hit
+int update_blocks() {
     for (int i = ROWS - 2; i >= 0; i--) { // Start from the bottom-most row
         for (int j = 0; j < COLS; j++) {
             if (grid[i][j] == '#') {
@@ -112,7 +142,7 @@ void update_blocks() {
                     blocks[j] = i + 1;    // Update block's position
                 } else if (i + 1 == ROWS - 1) { // Block reaches the player's row
                     if (j == player_pos) {
-                        handle_signal(0); // Game over if block hits player
+                        return 1; // Game over if block hits player
                     } else {
                         blocks[j] = -1; // Clear block when it reaches the bottom
                     }
@@ -120,35 +150,145 @@ void update_blocks() {
             }
         }
     }
+    return 0;
+}
+
+// Advance the falling blocks by one tick; returns 1 if the player was hit
+int step_game() {
+    block_fall_delay++;
+    if (block_fall_delay >= fall_delay) { // Delay block movement to make it manageable
+        if (update_blocks()) return 1;
+        spawn_blocks();
+        score++; // Increment score as time progresses
+        block_fall_delay = 0; // Reset delay
+    }
+    return 0;
+}
+
+// Pick an autoplay move: step towards the nearby column whose block is furthest away
+char autoplay_move() {
+    int best = player_pos;
+    int best_dist = -1;
+
+    for (int c = player_pos - 1; c <= player_pos + 1; c++) {
+        if (c < 0 || c >= COLS) continue;
+        int dist = blocks[c] == -1 ? ROWS : ROWS - 1 - blocks[c];
+        if (dist > best_dist || (dist == best_dist && c == player_pos)) {
+            best = c;
+            best_dist = dist;
+        }
+    }
+
+    if (best < player_pos) return 'a';
+    if (best > player_pos) return 'd';
+    return 0;
+}
+
+// Run headless with autoplay, writing compact frames for the main menu preview
+void run_preview() {
+    initialize_grid();
+
+    while (1) {
+        char move = autoplay_move();
+        if (move) move_player(move);
+
+        if (step_game()) { // Start over instead of ending the preview
+            score = 0;
+            block_fall_delay = 0;
+            player_pos = COLS / 2;
+            initialize_grid();
+        }
+
+        // One line per row, a blank line ends the frame
+        for (int i = 0; i < ROWS; i++) {
+            fwrite(grid[i], 1, COLS, stdout);
+            putchar('\n');
+        }
+        printf("Score: %d\n\n", score);
+        fflush(stdout);
+
+        usleep(100000);
+    }
 }
 
 // Main game function
-int main() {
+int main(int argc, char *argv[]) {
+    int render_mode = RENDER_TEXT;
+    int color = 0;
+
+    rng_seed(&rng, rng_seed_from_args(argc, argv));
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--density") == 0) { // Percent chance of a block per column
+            int percent = atoi(argv[i + 1]);
+            spawn_threshold = percent <= 0 ? 0 : percent >= 100 ? 255 : percent * 256 / 100;
+        }
+        if (i + 1 < argc && strcmp(argv[i], "--fall-delay") == 0) {
+            fall_delay = atoi(argv[i + 1]) > 0 ? atoi(argv[i + 1]) : 1;
+        }
+        if (i + 1 < argc && strcmp(argv[i], "--render") == 0) {
+            render_mode = render_parse_mode(argv[i + 1]);
+        }
+        if (strcmp(argv[i], "--color") == 0) {
+            color = 1;
+        }
+    }
+    if (render_mode < 0) {
+        fprintf(stderr, "Render modes are text, half and braille\n");
+        exit(1);
+    }
+    render_init(render_mode, color);
+    render_palette('#', 196); // Blocks
+    render_palette('O', 51);  // Player
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--preview") == 0) {
+            run_preview();
+        }
+        if (strcmp(argv[i], "--profile") == 0) {
+            prof_open();
+        }
+        if (strcmp(argv[i], "--rt") == 0) {
+            rt_open();
+            jitter_open();
+        }
+        if (strcmp(argv[i], "--jitter") == 0) {
+            jitter_open();
+        }
+    }
+
     printf("%c]0;%s%c", '\033', "avoid_blocks", '\007');
-    srand(time(NULL));
+    rng_log_seed("avoid_blocks", rng.seed);
+    hs_open(1); // Scores are simply not kept if the leaderboard is unavailable
     setup_terminal();
+    game_status_attach();
+    frame_ring_open("avoid_blocks");
     initialize_grid();
+    render_prepare(ROWS, COLS);
+    rt_lock_memory();
 
     while (1) {
+        prof_begin(PROF_RENDER);
         display_grid();
+        prof_end(PROF_RENDER);
 
+        char input = 0;
         if (kbhit()) {
-            char input = getchar();
+            input = getchar();
             if (input == 'q') break; // Quit the game
-            if (input == 'a' || input == 'd') {
-                move_player(input); // Move the player
-            }
         }
 
-        block_fall_delay++;
-        if (block_fall_delay >= 5) { // Delay block movement to make it manageable
-            update_blocks();
-            spawn_blocks();
-            score++; // Increment score as time progresses
-            block_fall_delay = 0; // Reset delay
+        prof_begin(PROF_SIMULATE);
+        if (input == 'a' || input == 'd') {
+            move_player(input); // Move the player
+        }
+        int hit = step_game();
+        prof_end(PROF_SIMULATE);
+
+        if (hit) {
+            handle_signal(0); // Game over if block hits player
         }
 
-        usleep(100000); // Control game loop speed
+        game_status_beat(score);
+        rt_tick_wait(TICK_NS); // Control game loop speed
     }
 
     handle_signal(0);
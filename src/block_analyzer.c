@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "rng.h"
+#include "block_patterns.h"
+
+#define MAX_COLS 64
+#define MAX_ROWS 64
+#define MAX_SETS 64
+#define MAX_THREADS 256
+#define CHUNK_GAMES 256   // Games per task: large enough that stealing is rare, small enough to balance
+#define CURVE_POINTS 10
+
+// One headless avoid_blocks game. The rules mirror avoid_blocks.c: one block per
+// column at a time, the player moves before blocks fall, a block hits when it
+// steps into the player's row, and every block step scores a point.
+struct sim {
+    int rows, cols, fall_delay;
+    int player;
+    int fall_counter;
+    int blocks[MAX_COLS]; // Row of the column's block, -1 if none
+    uint32_t score;
+    struct block_pattern pattern;
+    struct rng rng;       // Block spawns
+    struct rng bot_rng;   // Bot decisions, kept apart so bots do not change the blocks
+};
+
+struct param_set {
+    int rows, cols, density, fall_delay;
+};
+
+// A bot returns -1 to move left, 1 to move right or 0 to stay
+typedef int (*bot_fn)(struct sim *g);
+
+struct bot {
+    const char *name;
+    bot_fn choose;
+};
+
+struct task {
+    int set;
+    long first, count;
+};
+
+// Each worker owns a deque: it takes tasks from the bottom, thieves take from the top
+struct deque {
+    pthread_mutex_t lock;
+    struct task *tasks;
+    long top, bottom;
+};
+
+struct param_set sets[MAX_SETS];
+int set_count = 0;
+long games_per_set = 100000;
+uint32_t max_score = 2000;
+uint64_t master_seed;
+const struct bot *bot;
+
+uint32_t *scores;        // games_per_set results per set, indexed by game
+int thread_count;
+struct deque deques[MAX_THREADS];
+long steals[MAX_THREADS];
+
+void sim_init(struct sim *g, const struct param_set *p, uint64_t seed) {
+    memset(g, 0, sizeof(*g));
+    g->rows = p->rows;
+    g->cols = p->cols;
+    g->fall_delay = p->fall_delay;
+    g->player = p->cols / 2;
+    for (int i = 0; i < g->cols; i++) g->blocks[i] = -1;
+
+    int percent = p->density;
+    uint8_t threshold = percent <= 0 ? 0 : percent >= 100 ? 255 : percent * 256 / 100;
+    rng_seed(&g->rng, seed);
+    rng_seed(&g->bot_rng, seed ^ 0x5bd1e9955bd1e995ULL);
+    pattern_init(&g->pattern, g->cols, g->player, g->fall_delay, g->rows - 1, threshold);
+}
+
+// One tick; returns 1 if the player was hit
+int sim_tick(struct sim *g, int move) {
+    g->player += move;
+    if (g->player < 0) g->player = 0;
+    if (g->player >= g->cols) g->player = g->cols - 1;
+
+    if (++g->fall_counter < g->fall_delay) return 0;
+    g->fall_counter = 0;
+
+    uint64_t free = 0;
+    for (int i = 0; i < g->cols; i++) {
+        if (g->blocks[i] >= 0) {
+            if (++g->blocks[i] == g->rows - 1) { // Block reaches the player's row
+                if (i == g->player) return 1;
+                g->blocks[i] = -1;
+            }
+        }
+        if (g->blocks[i] == -1) free |= 1ULL << i;
+    }
+
+    uint64_t mask = pattern_next(&g->pattern, &g->rng, free);
+    for (int i = 0; i < g->cols; i++) {
+        if (mask & (1ULL << i)) g->blocks[i] = 0;
+    }
+    g->score++;
+    return 0;
+}
+
+// Never moves: a baseline for how much moving matters at all
+int bot_stay(struct sim *g) {
+    return 0;
+}
+
+int bot_random(struct sim *g) {
+    return (int)rng_below(&g->bot_rng, 3) - 1;
+}
+
+// Same rule as the avoid_blocks preview: step towards the nearby column whose block is furthest away
+int bot_greedy(struct sim *g) {
+    int best = g->player;
+    int best_dist = -1;
+
+    for (int c = g->player - 1; c <= g->player + 1; c++) {
+        if (c < 0 || c >= g->cols) continue;
+        int dist = g->blocks[c] == -1 ? g->rows : g->rows - 1 - g->blocks[c];
+        if (dist > best_dist || (dist == best_dist && c == g->player)) {
+            best = c;
+            best_dist = dist;
+        }
+    }
+    return best < g->player ? -1 : best > g->player;
+}
+
+// Plans over every block already falling: works backwards from the last landing to
+// find the columns that survive all of them, then heads for the nearest such column
+int bot_lookahead(struct sim *g) {
+    uint64_t all = g->cols >= 64 ? ~0ULL : (1ULL << g->cols) - 1;
+    uint64_t landing[MAX_ROWS] = {0}; // Columns hit at the k-th block step from now
+
+    for (int i = 0; i < g->cols; i++) {
+        if (g->blocks[i] >= 0) landing[g->rows - 1 - g->blocks[i]] |= 1ULL << i;
+    }
+
+    uint64_t safe = all;
+    for (int k = g->rows - 1; k >= 1; k--) {
+        uint64_t wider = safe;
+        for (int m = 0; m < g->fall_delay && wider != all; m++) wider = (wider | wider << 1 | wider >> 1) & all;
+        safe = wider & ~landing[k];
+    }
+
+    // Moves left before the next block step, this tick's included
+    int moves = g->fall_delay - g->fall_counter;
+    int best = -1;
+    for (int d = 0; d <= moves && best < 0; d++) {
+        if (g->player - d >= 0 && (safe >> (g->player - d)) & 1) best = g->player - d;
+        else if (g->player + d < g->cols && (safe >> (g->player + d)) & 1) best = g->player + d;
+    }
+    if (best < 0) return bot_greedy(g); // Nothing safe in reach
+    return best < g->player ? -1 : best > g->player;
+}
+
+const struct bot bots[] = {
+    {"stay", bot_stay},
+    {"random", bot_random},
+    {"greedy", bot_greedy},
+    {"lookahead", bot_lookahead},
+};
+
+// Every game has its own seed, so a result never depends on which thread played it
+uint64_t game_seed(int set, long game) {
+    return master_seed + ((uint64_t)set << 40) + (uint64_t)game;
+}
+
+void run_task(const struct task *t) {
+    struct sim g;
+    for (long i = t->first; i < t->first + t->count; i++) {
+        sim_init(&g, &sets[t->set], game_seed(t->set, i));
+        while (g.score < max_score && !sim_tick(&g, bot->choose(&g))) {
+        }
+        scores[(size_t)t->set * games_per_set + i] = g.score;
+    }
+}
+
+int pop_own(int self, struct task *out) {
+    struct deque *d = &deques[self];
+    int found = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->top < d->bottom) {
+        *out = d->tasks[--d->bottom];
+        found = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+int steal(int self, struct task *out) {
+    for (int k = 1; k < thread_count; k++) {
+        struct deque *d = &deques[(self + k) % thread_count];
+        int found = 0;
+        pthread_mutex_lock(&d->lock);
+        if (d->top < d->bottom) {
+            *out = d->tasks[d->top++];
+            found = 1;
+        }
+        pthread_mutex_unlock(&d->lock);
+        if (found) return 1;
+    }
+    return 0;
+}
+
+void *worker(void *arg) {
+    int self = (int)(intptr_t)arg;
+    struct task t;
+
+    // No task creates new ones, so once every deque is empty the work is done
+    while (1) {
+        if (pop_own(self, &t)) {
+            run_task(&t);
+        } else if (steal(self, &t)) {
+            steals[self]++;
+            run_task(&t);
+        } else {
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Deal tasks out in contiguous runs, so each worker starts on its own share
+void distribute_tasks() {
+    long chunks_per_set = (games_per_set + CHUNK_GAMES - 1) / CHUNK_GAMES;
+    long total = chunks_per_set * set_count;
+    long per_worker = (total + thread_count - 1) / thread_count;
+
+    for (int w = 0; w < thread_count; w++) {
+        pthread_mutex_init(&deques[w].lock, NULL);
+        deques[w].tasks = malloc(sizeof(struct task) * (per_worker > 0 ? per_worker : 1));
+        if (!deques[w].tasks) {
+            perror("Memory allocation failed");
+            exit(1);
+        }
+        deques[w].top = deques[w].bottom = 0;
+    }
+
+    for (long c = 0; c < total; c++) {
+        struct deque *d = &deques[c / per_worker];
+        struct task t = {(int)(c / chunks_per_set), (c % chunks_per_set) * CHUNK_GAMES, CHUNK_GAMES};
+        if (t.first + t.count > games_per_set) t.count = games_per_set - t.first;
+        d->tasks[d->bottom++] = t;
+    }
+}
+
+int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Survival curve and score distribution of one parameter set
+void report_set(int s) {
+    uint32_t *results = scores + (size_t)s * games_per_set;
+    qsort(results, games_per_set, sizeof(uint32_t), compare_u32); // Sorted by value, so order of play is irrelevant
+
+    double sum = 0;
+    long capped = 0;
+    for (long i = 0; i < games_per_set; i++) {
+        sum += results[i];
+        if (results[i] >= max_score) capped++;
+    }
+
+    const struct param_set *p = &sets[s];
+    printf("\nrows %d, cols %d, density %d%%, fall delay %d\n", p->rows, p->cols, p->density, p->fall_delay);
+    printf("  score mean %.1f  p10 %u  p25 %u  p50 %u  p75 %u  p90 %u  p99 %u  max %u\n", sum / games_per_set,
+           results[games_per_set / 10], results[games_per_set / 4], results[games_per_set / 2],
+           results[games_per_set * 3 / 4], results[games_per_set * 9 / 10], results[games_per_set * 99 / 100],
+           results[games_per_set - 1]);
+    printf("  reached the %u cap: %.2f%%\n", max_score, 100.0 * capped / games_per_set);
+
+    // Fraction of games still alive at evenly spaced scores
+    printf("  survival:");
+    long dead = 0;
+    for (int k = 1; k <= CURVE_POINTS; k++) {
+        uint32_t at = (uint32_t)((uint64_t)max_score * k / CURVE_POINTS);
+        while (dead < games_per_set && results[dead] < at) dead++;
+        printf(" %u:%.3f", at, (double)(games_per_set - dead) / games_per_set);
+    }
+    printf("\n");
+}
+
+// Parse "a,b,c" into values; returns how many were read
+int parse_list(const char *text, int *out, int max) {
+    int n = 0;
+    char *copy = strdup(text);
+    for (char *tok = strtok(copy, ","); tok && n < max; tok = strtok(NULL, ",")) {
+        out[n++] = atoi(tok);
+    }
+    free(copy);
+    return n;
+}
+
+void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [--games N] [--threads N] [--seed N] [--bot stay|random|greedy|lookahead]\n", name);
+    fprintf(stderr, "       [--rows N] [--cols A,B,..] [--density PCT,..] [--fall-delay A,B,..] [--max-score N]\n");
+    exit(1);
+}
+
+// Main function
+int main(int argc, char *argv[]) {
+    int rows = 15;
+    int cols[MAX_SETS] = {7}, densities[MAX_SETS] = {10}, delays[MAX_SETS] = {5};
+    int ncols = 1, ndensities = 1, ndelays = 1;
+
+    thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    bot = &bots[2];
+    master_seed = rng_seed_from_args(argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        const char *value = argv[++i];
+        if (strcmp(argv[i - 1], "--games") == 0) {
+            games_per_set = atol(value);
+        } else if (strcmp(argv[i - 1], "--threads") == 0) {
+            thread_count = atoi(value);
+        } else if (strcmp(argv[i - 1], "--max-score") == 0) {
+            max_score = strtoul(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--rows") == 0) {
+            rows = atoi(value);
+        } else if (strcmp(argv[i - 1], "--cols") == 0) {
+            ncols = parse_list(value, cols, MAX_SETS);
+        } else if (strcmp(argv[i - 1], "--density") == 0) {
+            ndensities = parse_list(value, densities, MAX_SETS);
+        } else if (strcmp(argv[i - 1], "--fall-delay") == 0) {
+            ndelays = parse_list(value, delays, MAX_SETS);
+        } else if (strcmp(argv[i - 1], "--bot") == 0) {
+            bot = NULL;
+            for (size_t b = 0; b < sizeof(bots) / sizeof(bots[0]); b++) {
+                if (strcmp(value, bots[b].name) == 0) bot = &bots[b];
+            }
+            if (!bot) usage(argv[0]);
+        } else if (strcmp(argv[i - 1], "--seed") != 0) {
+            usage(argv[0]);
+        }
+    }
+
+    if (games_per_set <= 0 || rows < 3 || rows > MAX_ROWS || max_score == 0) usage(argv[0]);
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > MAX_THREADS) thread_count = MAX_THREADS;
+
+    // Every combination of the listed values is one parameter set
+    for (int c = 0; c < ncols; c++) {
+        for (int d = 0; d < ndensities; d++) {
+            for (int f = 0; f < ndelays; f++) {
+                if (cols[c] < 1 || cols[c] > MAX_COLS || delays[f] < 1) usage(argv[0]);
+                if (set_count == MAX_SETS) {
+                    fprintf(stderr, "At most %d parameter sets\n", MAX_SETS);
+                    exit(1);
+                }
+                sets[set_count++] = (struct param_set){rows, cols[c], densities[d], delays[f]};
+            }
+        }
+    }
+
+    scores = malloc(sizeof(uint32_t) * games_per_set * set_count);
+    if (!scores) {
+        perror("Memory allocation failed");
+        exit(1);
+    }
+    distribute_tasks();
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_t threads[MAX_THREADS];
+    for (int w = 0; w < thread_count; w++) {
+        if (pthread_create(&threads[w], NULL, worker, (void *)(intptr_t)w) != 0) {
+            perror("Unable to start worker");
+            exit(1);
+        }
+    }
+    long total_steals = 0;
+    for (int w = 0; w < thread_count; w++) {
+        pthread_join(threads[w], NULL);
+        total_steals += steals[w];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%ld games x %d sets, bot %s, seed %llu\n", games_per_set, set_count, bot->name,
+           (unsigned long long)master_seed);
+    printf("%.2f s on %d threads, %.0f games/s, %ld tasks stolen\n", seconds, thread_count,
+           games_per_set * set_count / seconds, total_steals);
+
+    for (int s = 0; s < set_count; s++) {
+        report_set(s);
+    }
+    return 0;
+}
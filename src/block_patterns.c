@@ -0,0 +1,39 @@
+#include "block_patterns.h"
+
+// Columns reachable from `set` within `moves` single-column moves
+static uint64_t expand(const struct block_pattern *p, uint64_t set, int moves) {
+    for (int i = 0; i < moves && set != p->all; i++) {
+        set |= (set << 1) | (set >> 1);
+        set &= p->all;
+    }
+    return set;
+}
+
+void pattern_init(struct block_pattern *p, int cols, int start, int moves_per_row, int rows_ahead,
+                  uint8_t threshold) {
+    p->cols = cols;
+    p->moves_per_row = moves_per_row;
+    p->threshold = threshold;
+    p->all = cols >= 64 ? ~0ULL : (1ULL << cols) - 1;
+    p->repaired = 0;
+
+    // Nothing falls before the first row lands, so the player can be anywhere in range by then
+    p->reachable = expand(p, 1ULL << start, moves_per_row * rows_ahead);
+}
+
+uint64_t pattern_next(struct block_pattern *p, struct rng *r, uint64_t free) {
+    uint64_t mask = rng_mask(r, p->cols, p->threshold) & free;
+    uint64_t span = expand(p, p->reachable, p->moves_per_row);
+
+    if ((span & ~mask) == 0) {
+        // Every column in range is blocked: clear one of them at random
+        uint64_t blocking = span & mask;
+        uint32_t pick = rng_below(r, __builtin_popcountll(blocking));
+        while (pick--) blocking &= blocking - 1;
+        mask &= ~(blocking & -blocking);
+        p->repaired++;
+    }
+
+    p->reachable = span & ~mask;
+    return mask;
+}
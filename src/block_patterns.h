@@ -0,0 +1,31 @@
+#ifndef BLOCK_PATTERNS_H
+#define BLOCK_PATTERNS_H
+
+#include <stdint.h>
+#include "rng.h"
+
+// Spawn masks for avoid_blocks that always leave the player a way through.
+//
+// Column c of a mask is bit c (at most 64 columns). The generator keeps one bitmask:
+// the columns the player could be standing in when the newest spawned row reaches
+// the bottom. Each new row only widens that set by the distance the player can move
+// while blocks fall one row and removes the row's blocks, so a check costs a few
+// shifts no matter how many rows are already falling.
+struct block_pattern {
+    int cols;
+    int moves_per_row;   // Player moves between two block steps (the fall delay)
+    uint8_t threshold;   // Chance of a block per column, out of 256
+    uint64_t all;        // Mask of every column
+    uint64_t reachable;  // Player columns when the newest row lands; never empty
+    uint64_t repaired;   // Rows that had a block removed to keep a path open
+};
+
+// start: the player's column; rows_ahead: block steps before a spawned row lands
+void pattern_init(struct block_pattern *p, int cols, int start, int moves_per_row, int rows_ahead,
+                  uint8_t threshold);
+
+// Draw the next row from `free` (columns that may take a block) and repair it if it
+// would leave no reachable column. Returns the mask of blocks to spawn.
+uint64_t pattern_next(struct block_pattern *p, struct rng *r, uint64_t free);
+
+#endif
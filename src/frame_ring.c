@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include "frame_ring.h"
+
+static struct frame_ring *own_ring = NULL;
+static char own_name[64];
+
+// Mark the ring closed for spectators and remove its name
+static void frame_ring_close() {
+    if (!own_ring) return;
+    atomic_store(&own_ring->closed, 1);
+    shm_unlink(own_name);
+    munmap(own_ring, sizeof(struct frame_ring));
+    own_ring = NULL;
+}
+
+void frame_ring_open(const char *game) {
+    snprintf(own_name, sizeof(own_name), "/%s%s-%d", FRAME_RING_PREFIX, game, (int)getpid());
+
+    int fd = shm_open(own_name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) return; // Spectating is optional; the game runs the same without it
+
+    // Pages are only allocated once frames are written to them
+    if (ftruncate(fd, sizeof(struct frame_ring)) < 0) {
+        close(fd);
+        shm_unlink(own_name);
+        return;
+    }
+    void *p = mmap(NULL, sizeof(struct frame_ring), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(own_name);
+        return;
+    }
+
+    own_ring = p;
+    own_ring->publisher_pid = getpid();
+    own_ring->magic = FRAME_RING_MAGIC; // Written last: readers ignore the ring until it is set up
+    atexit(frame_ring_close);
+}
+
+void frame_ring_publish(const char *frame, size_t len) {
+    if (!own_ring || len > FRAME_RING_SLOT_SIZE) return;
+
+    uint64_t seq = atomic_load_explicit(&own_ring->head, memory_order_relaxed) + 1;
+    struct frame_slot *slot = &own_ring->slots[seq % FRAME_RING_SLOTS];
+
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release); // Readers see seq 0 before any new bytes
+    slot->length = len;
+    memcpy(slot->data, frame, len);
+    atomic_store_explicit(&slot->seq, seq, memory_order_release);
+    atomic_store_explicit(&own_ring->head, seq, memory_order_release);
+}
+
+const struct frame_ring *frame_ring_attach(const char *name) {
+    char path[80];
+    snprintf(path, sizeof(path), "/%s", name);
+
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    void *p = mmap(NULL, sizeof(struct frame_ring), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return NULL;
+
+    const struct frame_ring *ring = p;
+    if (ring->magic != FRAME_RING_MAGIC) {
+        munmap(p, sizeof(struct frame_ring));
+        return NULL;
+    }
+    return ring;
+}
+
+long frame_ring_read(const struct frame_ring *ring, uint64_t seq, char *out) {
+    const struct frame_slot *slot = &ring->slots[seq % FRAME_RING_SLOTS];
+
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != seq) return -1;
+    uint32_t len = slot->length;
+    if (len > FRAME_RING_SLOT_SIZE) return -1;
+    memcpy(out, slot->data, len);
+    atomic_thread_fence(memory_order_acquire); // The copy is finished before seq is checked again
+    if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) return -1;
+    return len;
+}
@@ -0,0 +1,46 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+// Shared-memory broadcast of a game's rendered frames, named /vgc-<game>-<pid>.
+// One game writes, any number of spectators read. Every frame redraws the whole
+// screen, so each one is a keyframe: a reader that falls behind skips to the newest.
+#define FRAME_RING_PREFIX "vgc-"
+#define FRAME_RING_MAGIC 0x56474652 // "VGFR"
+#define FRAME_RING_SLOTS 8
+#define FRAME_RING_SLOT_SIZE 262144
+
+// Each slot is a seqlock: seq is 0 while the slot is rewritten and the frame's
+// sequence number once it is complete, so a reader detects a torn copy.
+struct frame_slot {
+    _Atomic uint64_t seq;
+    uint32_t length;
+    uint32_t reserved;
+    char data[FRAME_RING_SLOT_SIZE];
+};
+
+struct frame_ring {
+    uint32_t magic;
+    int32_t publisher_pid;
+    _Atomic uint64_t head;   // Sequence number of the newest complete frame, 0 before the first
+    _Atomic int32_t closed;  // Set when the game exits
+    struct frame_slot slots[FRAME_RING_SLOTS];
+};
+
+// Game side: create the ring. Without one, publishing is a no-op.
+void frame_ring_open(const char *game);
+
+// Copy a frame into the next slot. Never waits for readers.
+void frame_ring_publish(const char *frame, size_t len);
+
+// Spectator side: map a ring read-only by its name (without the leading '/')
+const struct frame_ring *frame_ring_attach(const char *name);
+
+// Copy the frame with sequence number seq; returns its length, or -1 if the slot
+// was overwritten or is being written
+long frame_ring_read(const struct frame_ring *ring, uint64_t seq, char *out);
+
+#endif
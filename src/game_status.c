@@ -0,0 +1,59 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "game_status.h"
+
+static struct game_status *own_status = NULL;
+
+struct game_status *game_status_create(int *fd) {
+    *fd = memfd_create("vgc-status", MFD_CLOEXEC); // Only the game it is meant for gets it
+    if (*fd < 0) return NULL;
+
+    if (ftruncate(*fd, sizeof(struct game_status)) < 0) {
+        close(*fd);
+        return NULL;
+    }
+
+    void *p = mmap(NULL, sizeof(struct game_status), PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+    if (p == MAP_FAILED) {
+        close(*fd);
+        return NULL;
+    }
+    return p; // A fresh memfd is zero-filled: no beats yet, state unknown
+}
+
+void game_status_destroy(struct game_status *status, int fd) {
+    if (status) munmap(status, sizeof(struct game_status));
+    if (fd >= 0) close(fd);
+}
+
+void game_status_attach() {
+    const char *env = getenv(GAME_STATUS_ENV);
+    if (!env) return; // Started outside main_screen
+
+    int fd = atoi(env);
+    void *p = mmap(NULL, sizeof(struct game_status), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p != MAP_FAILED) own_status = p;
+}
+
+// Publish one completed tick
+void game_status_beat(int score) {
+    if (!own_status) return;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    atomic_store(&own_status->score, score);
+    atomic_store(&own_status->last_beat_ns, (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+    atomic_fetch_add(&own_status->heartbeat, 1);
+    atomic_store(&own_status->state, GS_RUNNING);
+}
+
+void game_status_set_state(enum game_activity state) {
+    if (!own_status) return;
+    atomic_store(&own_status->state, state);
+}
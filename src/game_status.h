@@ -0,0 +1,29 @@
+#ifndef GAME_STATUS_H
+#define GAME_STATUS_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Environment variable carrying the status page's file descriptor into a game
+#define GAME_STATUS_ENV "VGC_STATUS_FD"
+
+enum game_activity { GS_UNKNOWN, GS_RUNNING, GS_WAITING_INPUT, GS_OVER };
+
+// One shared page per running game: the game writes it, main_screen reads it
+struct game_status {
+    _Atomic uint64_t heartbeat;    // Ticks completed
+    _Atomic int64_t last_beat_ns;  // CLOCK_MONOTONIC time of the last tick
+    _Atomic int32_t score;
+    _Atomic int32_t state;         // enum game_activity
+};
+
+// main_screen side: create a page backed by a memfd that a child can inherit
+struct game_status *game_status_create(int *fd);
+void game_status_destroy(struct game_status *status, int fd);
+
+// Game side: map the page named by GAME_STATUS_ENV; everything is a no-op without one
+void game_status_attach();
+void game_status_beat(int score);
+void game_status_set_state(enum game_activity state);
+
+#endif
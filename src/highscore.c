@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "highscore.h"
+
+#define HS_MAGIC 0x3130534843475600ULL // "\0VGCHS01"
+
+// Every record is a single 64-bit word so it can be replaced with one CAS:
+//   bits 63..32 score | bits 31..8 hour stamp | bits 7..0 check byte
+// A check byte always has its top bit set, so an all-zero word is an empty slot
+// and a torn or scribbled word fails validation instead of showing up as a score.
+struct hs_table {
+    _Atomic uint64_t key; // Hash of the game name, 0 while the table is free
+    _Atomic uint64_t slots[HS_TOP_K];
+};
+
+struct hs_file {
+    _Atomic uint64_t magic;
+    uint64_t reserved[7];
+    struct hs_table tables[HS_MAX_TABLES];
+};
+
+static struct hs_file *hs_map = NULL;
+static int hs_writable = 0;
+
+// FNV-1a hash of the game name, never 0 so it cannot look like a free table
+static uint64_t hs_key(const char *game) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const char *p = game; *p; p++) {
+        h ^= (unsigned char)*p;
+        h *= 0x100000001b3ULL;
+    }
+    return h | 1;
+}
+
+static uint8_t hs_check(uint64_t upper) {
+    return (uint8_t)(((upper * 0x9E3779B97F4A7C15ULL) >> 57) | 0x80);
+}
+
+static uint64_t hs_pack(uint32_t score, uint32_t hour) {
+    uint64_t upper = ((uint64_t)score << 24) | (hour & 0xFFFFFF);
+    return (upper << 8) | hs_check(upper);
+}
+
+static int hs_valid(uint64_t rec) {
+    return rec != 0 && (uint8_t)rec == hs_check(rec >> 8);
+}
+
+// Map the leaderboard file
+int hs_open(int writable) {
+    if (hs_map) return 0;
+
+    int fd = open(HS_FILE, writable ? O_RDWR | O_CREAT : O_RDONLY, 0666);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size < (off_t)sizeof(struct hs_file)) {
+        // Growing with zeros is idempotent, so racing creators cannot clobber each other
+        if (!writable || ftruncate(fd, sizeof(struct hs_file)) < 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    void *p = mmap(NULL, sizeof(struct hs_file), writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                   MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+
+    struct hs_file *f = p;
+    uint64_t magic = atomic_load(&f->magic);
+    if (writable && magic == 0) {
+        atomic_compare_exchange_strong(&f->magic, &magic, HS_MAGIC);
+        magic = atomic_load(&f->magic);
+    }
+    if (magic != HS_MAGIC) {
+        // Not our file (or an unknown version): leave it alone
+        munmap(p, sizeof(struct hs_file));
+        return -1;
+    }
+
+    hs_map = f;
+    hs_writable = writable;
+    return 0;
+}
+
+// Find the game's table, claiming a free one when writing
+static struct hs_table *hs_table_for(const char *game, int claim) {
+    uint64_t key = hs_key(game);
+
+    for (int i = 0; i < HS_MAX_TABLES; i++) {
+        struct hs_table *t = &hs_map->tables[i];
+        uint64_t cur = atomic_load(&t->key);
+        if (cur == key) return t;
+        if (cur == 0) {
+            if (!claim) return NULL; // Tables are claimed in order, so the game has none
+            uint64_t expected = 0;
+            if (atomic_compare_exchange_strong(&t->key, &expected, key) || expected == key) {
+                return t;
+            }
+            // Another game won this table; keep looking
+        }
+    }
+    return NULL;
+}
+
+// Offer a score, replacing the weakest record with a CAS and retrying on contention
+int hs_submit(const char *game, uint32_t score) {
+    if (!hs_map || !hs_writable) return -1;
+
+    struct hs_table *t = hs_table_for(game, 1);
+    if (!t) return -1;
+
+    uint64_t rec = hs_pack(score, (uint32_t)(time(NULL) / 3600));
+
+    while (1) {
+        int victim = -1;
+        uint64_t victim_rec = 0;
+        int64_t victim_score = INT64_MAX;
+        int64_t best_score = -1;
+
+        for (int i = 0; i < HS_TOP_K; i++) {
+            uint64_t cur = atomic_load(&t->slots[i]);
+            // Empty and corrupted slots rank below any real score
+            int64_t s = hs_valid(cur) ? (int64_t)(cur >> 32) : -1;
+            if (s < victim_score) {
+                victim = i;
+                victim_rec = cur;
+                victim_score = s;
+            }
+            if (s > best_score) best_score = s;
+        }
+
+        if ((int64_t)score <= victim_score) return 0;
+
+        if (atomic_compare_exchange_weak(&t->slots[victim], &victim_rec, rec)) {
+            return (int64_t)score > best_score ? 2 : 1;
+        }
+    }
+}
+
+// Copy the best records straight out of the mapping
+int hs_top(const char *game, struct hs_entry *out, int k) {
+    if (!hs_map) return 0;
+
+    struct hs_table *t = hs_table_for(game, 0);
+    if (!t) return 0;
+
+    struct hs_entry found[HS_TOP_K];
+    int n = 0;
+
+    for (int i = 0; i < HS_TOP_K; i++) {
+        uint64_t cur = atomic_load(&t->slots[i]);
+        if (!hs_valid(cur)) continue;
+
+        struct hs_entry e = {(uint32_t)(cur >> 32), (uint32_t)((cur >> 8) & 0xFFFFFF)};
+        int j = n++;
+        while (j > 0 && found[j - 1].score < e.score) {
+            found[j] = found[j - 1];
+            j--;
+        }
+        found[j] = e;
+    }
+
+    if (n > k) n = k;
+    memcpy(out, found, sizeof(struct hs_entry) * n);
+    return n;
+}
+
+void hs_close() {
+    if (hs_map) {
+        munmap(hs_map, sizeof(struct hs_file));
+        hs_map = NULL;
+    }
+}
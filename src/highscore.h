@@ -0,0 +1,29 @@
+#ifndef HIGHSCORE_H
+#define HIGHSCORE_H
+
+#include <stdint.h>
+
+// Leaderboard shared by every game, kept in the console's working directory
+#define HS_FILE "highscores.vgc"
+#define HS_MAX_TABLES 16 // One table per game title
+#define HS_TOP_K 10      // Records kept per game
+
+struct hs_entry {
+    uint32_t score;
+    uint32_t hour; // Hours since the Unix epoch when the score was set
+};
+
+// Map the leaderboard file; writers create it if missing. Returns 0 on success, -1 otherwise.
+int hs_open(int writable);
+
+// Offer a score for a game. Returns 2 if it beats every kept record, 1 if it only made
+// the top-k, 0 if neither, -1 on error.
+// Only touches the mapping with atomics, so it is safe to call from a signal handler.
+int hs_submit(const char *game, uint32_t score);
+
+// Copy up to k best records for a game into out, highest first. Returns the count.
+int hs_top(const char *game, struct hs_entry *out, int k);
+
+void hs_close();
+
+#endif
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "level.h"
+
+#define LEVEL_MAX_SIDE 65536
+#define LEVEL_MAX_PORTALS (1u << 24)
+
+static uint64_t hash_cell(uint64_t cell) {
+    cell ^= cell >> 33;
+    cell *= 0xff51afd7ed558ccdULL;
+    return cell ^ (cell >> 33);
+}
+
+// Constant-time lookup of the portal leaving a cell; returns 0 if there is none
+static int portal_lookup(const struct level *lv, uint64_t cell, uint64_t *dest) {
+    if (!lv->portal_cells) return 0;
+
+    for (uint32_t i = hash_cell(cell) & lv->portal_mask;; i = (i + 1) & lv->portal_mask) {
+        if (lv->portal_cells[i] == 0) return 0;
+        if (lv->portal_cells[i] == cell + 1) {
+            *dest = lv->portal_dest[i];
+            return 1;
+        }
+    }
+}
+
+// Build the portal table; the table is kept at most half full so probes stay short
+static int build_portals(struct level *lv, const struct level_portal *portals, uint32_t count) {
+    uint32_t size = 2;
+    while (size < count * 2) size <<= 1;
+
+    lv->portal_cells = calloc(size, sizeof(uint64_t));
+    lv->portal_dest = malloc(size * sizeof(uint64_t));
+    if (!lv->portal_cells || !lv->portal_dest) return -1;
+    lv->portal_mask = size - 1;
+
+    for (uint32_t p = 0; p < count; p++) {
+        const struct level_portal *pt = &portals[p];
+        // level_step follows a portal before it checks for walls, so neither end may be one
+        if (pt->row >= lv->rows || pt->col >= lv->cols || pt->to_row >= lv->rows || pt->to_col >= lv->cols ||
+            level_wall(lv, pt->row, pt->col) || level_wall(lv, pt->to_row, pt->to_col)) {
+            fprintf(stderr, "Level portal %u is out of bounds or touches a wall\n", p);
+            return -1;
+        }
+
+        uint64_t cell = (uint64_t)pt->row * lv->cols + pt->col;
+        uint32_t i = hash_cell(cell) & lv->portal_mask;
+        while (lv->portal_cells[i] != 0 && lv->portal_cells[i] != cell + 1) {
+            i = (i + 1) & lv->portal_mask;
+        }
+        lv->portal_cells[i] = cell + 1;
+        lv->portal_dest[i] = (uint64_t)pt->to_row * lv->cols + pt->to_col;
+    }
+    return 0;
+}
+
+int level_load(struct level *lv, const char *path) {
+    memset(lv, 0, sizeof(*lv));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Unable to open level");
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(struct level_header)) {
+        fprintf(stderr, "%s is not a level file\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Unable to map level");
+        return -1;
+    }
+    lv->map = map;
+    lv->map_size = st.st_size;
+
+    // Check every size and offset against the file before trusting any of it
+    const struct level_header *h = map;
+    uint64_t walls_bytes = (uint64_t)h->rows * h->words_per_row * sizeof(uint64_t);
+    uint64_t portals_bytes = (uint64_t)h->portal_count * sizeof(struct level_portal);
+
+    if (memcmp(h->magic, LEVEL_MAGIC, 4) != 0 || h->version != LEVEL_VERSION ||
+        h->rows == 0 || h->cols == 0 || h->rows > LEVEL_MAX_SIDE || h->cols > LEVEL_MAX_SIDE ||
+        h->words_per_row != (h->cols + 63) / 64 || h->portal_count > LEVEL_MAX_PORTALS ||
+        h->walls_offset % sizeof(uint64_t) != 0 || h->portals_offset % sizeof(uint32_t) != 0 ||
+        h->walls_offset > lv->map_size || walls_bytes > lv->map_size - h->walls_offset ||
+        h->portals_offset > lv->map_size || portals_bytes > lv->map_size - h->portals_offset) {
+        fprintf(stderr, "%s is not a valid level file\n", path);
+        level_free(lv);
+        return -1;
+    }
+
+    lv->rows = h->rows;
+    lv->cols = h->cols;
+    lv->wrap = (h->flags & LEVEL_WRAP) != 0;
+    lv->start_row = h->start_row;
+    lv->start_col = h->start_col;
+    lv->words_per_row = h->words_per_row;
+    lv->walls = (const uint64_t *)((const char *)map + h->walls_offset);
+
+    // Bits past the last column would name cells outside the board
+    if (lv->cols % 64) {
+        uint64_t padding = ~0ULL << (lv->cols % 64);
+        for (uint32_t r = 0; r < lv->rows; r++) {
+            if (lv->walls[(size_t)r * lv->words_per_row + lv->words_per_row - 1] & padding) {
+                fprintf(stderr, "%s has walls past the last column\n", path);
+                level_free(lv);
+                return -1;
+            }
+        }
+    }
+
+    if (lv->start_row >= lv->rows || lv->start_col >= lv->cols || level_wall(lv, lv->start_row, lv->start_col)) {
+        fprintf(stderr, "%s has no valid start cell\n", path);
+        level_free(lv);
+        return -1;
+    }
+
+    if (h->portal_count > 0 &&
+        build_portals(lv, (const struct level_portal *)((const char *)map + h->portals_offset), h->portal_count) < 0) {
+        level_free(lv);
+        return -1;
+    }
+    return 0;
+}
+
+void level_blank(struct level *lv, uint32_t rows, uint32_t cols) {
+    memset(lv, 0, sizeof(*lv));
+    lv->rows = rows;
+    lv->cols = cols;
+    lv->start_row = rows / 2;
+    lv->start_col = cols / 2;
+    lv->words_per_row = (cols + 63) / 64;
+}
+
+void level_free(struct level *lv) {
+    if (lv->map) munmap(lv->map, lv->map_size);
+    free(lv->portal_cells);
+    free(lv->portal_dest);
+    memset(lv, 0, sizeof(*lv));
+}
+
+int level_step(const struct level *lv, uint32_t row, uint32_t col, char dir,
+               uint32_t *out_row, uint32_t *out_col) {
+    int64_t r = row, c = col;
+
+    switch (dir) {
+        case 'w': r--; break;
+        case 'a': c--; break;
+        case 's': r++; break;
+        case 'd': c++; break;
+    }
+
+    if (r < 0 || r >= lv->rows || c < 0 || c >= lv->cols) {
+        if (!lv->wrap) return 0;
+        r = (r + lv->rows) % lv->rows;
+        c = (c + lv->cols) % lv->cols;
+    }
+
+    uint64_t dest;
+    if (portal_lookup(lv, (uint64_t)r * lv->cols + c, &dest)) {
+        r = dest / lv->cols;
+        c = dest % lv->cols;
+    }
+
+    if (level_wall(lv, r, c)) return 0;
+    *out_row = r;
+    *out_col = c;
+    return 1;
+}
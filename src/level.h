@@ -0,0 +1,70 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Binary level file, little-endian:
+//   struct level_header at offset 0
+//   wall bitmap at walls_offset: rows * words_per_row 64-bit words, bit c of a row is column c
+//   portals at portals_offset: portal_count struct level_portal entries
+#define LEVEL_MAGIC "VGCL"
+#define LEVEL_VERSION 1
+#define LEVEL_WRAP 1 // Leaving one edge enters the opposite one instead of hitting a wall
+
+struct level_header {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t rows, cols;
+    uint32_t start_row, start_col;
+    uint32_t words_per_row;
+    uint32_t portal_count;
+    uint64_t walls_offset;
+    uint64_t portals_offset;
+    uint8_t reserved[16];
+};
+
+// Entering (row, col) moves the head on to (to_row, to_col). Pairs are stored both ways.
+struct level_portal {
+    uint32_t row, col;
+    uint32_t to_row, to_col;
+};
+
+// A loaded level. The wall bitmap is used straight from the read-only mapping, so
+// every process playing the same file shares its pages through the page cache.
+struct level {
+    uint32_t rows, cols;
+    int wrap;
+    uint32_t start_row, start_col;
+    uint32_t words_per_row;
+    const uint64_t *walls;  // NULL for an open board
+
+    // Portal table built at load time: open addressing keyed by cell index
+    uint64_t *portal_cells; // Cell index + 1, 0 for an empty slot
+    uint64_t *portal_dest;
+    uint32_t portal_mask;
+
+    void *map;
+    size_t map_size;
+};
+
+// Map and validate a level file. Returns 0 on success; on failure prints why and returns -1.
+int level_load(struct level *lv, const char *path);
+
+// An open board with hard edges, matching the classic game
+void level_blank(struct level *lv, uint32_t rows, uint32_t cols);
+
+void level_free(struct level *lv);
+
+static inline int level_wall(const struct level *lv, uint32_t row, uint32_t col) {
+    if (!lv->walls) return 0;
+    return (lv->walls[(size_t)row * lv->words_per_row + (col >> 6)] >> (col & 63)) & 1;
+}
+
+// Cell reached by moving one step from (row, col) in direction 'w', 'a', 's' or 'd',
+// following wrap-around and portals. Returns 0 if the move runs into a wall or an edge.
+int level_step(const struct level *lv, uint32_t row, uint32_t col, char dir,
+               uint32_t *out_row, uint32_t *out_col);
+
+#endif
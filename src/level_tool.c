@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "level.h"
+#include "rng.h"
+
+#define MAX_LINE 65600
+
+// Write a level file: header, wall bitmap, then portals
+int write_level(const char *path, struct level_header *h, const uint64_t *walls, const struct level_portal *portals) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror("Unable to create level");
+        return -1;
+    }
+
+    size_t words = (size_t)h->rows * h->words_per_row;
+    memcpy(h->magic, LEVEL_MAGIC, 4);
+    h->version = LEVEL_VERSION;
+    h->walls_offset = sizeof(struct level_header);
+    h->portals_offset = h->walls_offset + words * sizeof(uint64_t);
+
+    if (fwrite(h, sizeof(*h), 1, f) != 1 ||
+        fwrite(walls, sizeof(uint64_t), words, f) != words ||
+        fwrite(portals, sizeof(struct level_portal), h->portal_count, f) != h->portal_count) {
+        perror("Unable to write level");
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    printf("%s: %ux%u, %u portals\n", path, h->rows, h->cols, h->portal_count);
+    return 0;
+}
+
+// Build a level from a text map: '#' wall, 'S' start, a letter used twice is a portal pair.
+// A first line reading "wrap" makes the edges wrap around.
+int build_level(const char *map_path, const char *out_path) {
+    FILE *f = fopen(map_path, "r");
+    if (!f) {
+        perror("Unable to open map");
+        return 1;
+    }
+
+    static char line[MAX_LINE];
+    char **lines = NULL;
+    struct level_header h = {0};
+    uint32_t max_cols = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (h.rows == 0 && !lines && strcmp(line, "wrap") == 0) {
+            h.flags |= LEVEL_WRAP;
+            continue;
+        }
+        lines = realloc(lines, sizeof(char *) * (h.rows + 1));
+        lines[h.rows++] = strdup(line);
+        if (strlen(line) > max_cols) max_cols = strlen(line);
+    }
+    fclose(f);
+
+    if (h.rows == 0 || max_cols == 0) {
+        fprintf(stderr, "%s is empty\n", map_path);
+        return 1;
+    }
+    h.cols = max_cols;
+    h.words_per_row = (h.cols + 63) / 64;
+    h.start_row = h.rows / 2;
+    h.start_col = h.cols / 2;
+
+    uint64_t *walls = calloc((size_t)h.rows * h.words_per_row, sizeof(uint64_t));
+    if (!walls) {
+        perror("Memory allocation failed");
+        return 1;
+    }
+    struct level_portal portals[2 * 52];
+    int first_row[52], first_col[52];
+    memset(first_row, -1, sizeof(first_row));
+
+    for (uint32_t r = 0; r < h.rows; r++) {
+        for (uint32_t c = 0; lines[r][c]; c++) {
+            char ch = lines[r][c];
+            if (ch == '#') {
+                walls[(size_t)r * h.words_per_row + c / 64] |= 1ULL << (c % 64);
+            } else if (ch == 'S') {
+                h.start_row = r;
+                h.start_col = c;
+            } else if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'R') || (ch >= 'T' && ch <= 'Z')) {
+                int p = ch >= 'a' ? ch - 'a' : 26 + ch - 'A';
+                if (first_row[p] == -2) {
+                    fprintf(stderr, "Portal %c is used more than twice\n", ch);
+                    free(walls);
+                    return 1;
+                } else if (first_row[p] == -1) {
+                    first_row[p] = r;
+                    first_col[p] = c;
+                } else {
+                    // Store the pair both ways
+                    portals[h.portal_count++] = (struct level_portal){first_row[p], first_col[p], r, c};
+                    portals[h.portal_count++] = (struct level_portal){r, c, first_row[p], first_col[p]};
+                    first_row[p] = -2;
+                }
+            }
+        }
+        free(lines[r]);
+    }
+    free(lines);
+
+    for (int p = 0; p < 52; p++) {
+        if (first_row[p] >= 0) {
+            fprintf(stderr, "Portal at row %d, column %d has no partner\n", first_row[p], first_col[p]);
+            free(walls);
+            return 1;
+        }
+    }
+
+    int result = write_level(out_path, &h, walls, portals) < 0;
+    free(walls);
+    return result;
+}
+
+// Random walls with the given density in percent; the start and its neighbours are kept free
+int random_level(int rows, int cols, int density, const char *out_path, uint64_t seed) {
+    if (rows <= 0 || cols <= 0 || rows > 65536 || cols > 65536) {
+        fprintf(stderr, "Level size must be between 1 and 65536\n");
+        return 1;
+    }
+
+    struct level_header h = {0};
+    h.rows = rows;
+    h.cols = cols;
+    h.words_per_row = (h.cols + 63) / 64;
+    h.start_row = rows / 2;
+    h.start_col = cols / 2;
+
+    uint64_t *walls = malloc((size_t)h.rows * h.words_per_row * sizeof(uint64_t));
+    if (!walls) {
+        perror("Memory allocation failed");
+        return 1;
+    }
+
+    struct rng rng;
+    rng_seed(&rng, seed);
+    uint8_t threshold = density * 256 / 100 > 255 ? 255 : density * 256 / 100;
+    for (uint32_t r = 0; r < h.rows; r++) {
+        uint64_t *row = walls + (size_t)r * h.words_per_row;
+        for (uint32_t w = 0; w < h.words_per_row; w++) {
+            row[w] = rng_mask(&rng, 64, threshold);
+        }
+        if (h.cols % 64) row[h.words_per_row - 1] &= (1ULL << (h.cols % 64)) - 1;
+    }
+
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int dc = -1; dc <= 1; dc++) {
+            int r = h.start_row + dr, c = h.start_col + dc;
+            if (r < 0 || r >= rows || c < 0 || c >= cols) continue;
+            walls[(size_t)r * h.words_per_row + c / 64] &= ~(1ULL << (c % 64));
+        }
+    }
+
+    int result = write_level(out_path, &h, walls, NULL) < 0;
+    free(walls);
+    return result;
+}
+
+// Time how long loading a level takes
+int bench_level(const char *path) {
+    const int runs = 100;
+    struct level lv;
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < runs; i++) {
+        if (level_load(&lv, path) < 0) return 1;
+        if (i < runs - 1) level_free(&lv);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double ms = ((end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6) / runs;
+    printf("%s: %ux%u, %.3f ms per load\n", path, lv.rows, lv.cols, ms);
+    level_free(&lv);
+    return 0;
+}
+
+// Main function
+int main(int argc, char *argv[]) {
+    if (argc == 4 && strcmp(argv[1], "build") == 0) {
+        return build_level(argv[2], argv[3]);
+    }
+    if (argc >= 6 && strcmp(argv[1], "random") == 0) {
+        return random_level(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), argv[5], rng_seed_from_args(argc, argv));
+    }
+    if (argc == 3 && strcmp(argv[1], "bench") == 0) {
+        return bench_level(argv[2]);
+    }
+
+    fprintf(stderr, "Usage: %s build MAP.txt OUT.lvl\n", argv[0]);
+    fprintf(stderr, "       %s random ROWS COLS DENSITY%% OUT.lvl [--seed N]\n", argv[0]);
+    fprintf(stderr, "       %s bench FILE.lvl\n", argv[0]);
+    return 1;
+}
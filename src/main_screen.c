@@ -8,8 +8,41 @@
 #include <sys/select.h>
 #include <time.h>
 #include <sys/wait.h>
+#include <fcntl.h>
+#include <errno.h>
+#include "highscore.h"
+#include "game_status.h"
+#include "rt_mode.h"
+#include "session_stats.h"
 
 #define MAX_GAMES 10
+#define TOP_SCORES_SHOWN 3
+#define RECENT_SESSIONS 10          // Sessions in the "recent" column of the stats screen
+
+#define PREVIEW_FRAMES 150          // Frames cached per game (15 seconds of animation)
+#define PREVIEW_ROWS 18
+#define PREVIEW_COLS 32
+#define PREVIEW_SCREEN_COL 48       // Terminal column the preview is drawn at
+#define PREVIEW_INTERVAL_US 100000  // One preview frame per game tick
+#define IDLE_TIMEOUT 60             // Seconds without input before previews pause
+
+#define FOREGROUND_POLL_US 10000    // How often a running game is checked on
+#define HUNG_TIMEOUT_US 3000000     // A running game that has not ticked for this long is hung
+
+enum preview_state { PREVIEW_NONE, PREVIEW_FILLING, PREVIEW_CACHED, PREVIEW_FAILED };
+
+// Headless run of a game used to animate its menu entry
+struct preview {
+    enum preview_state state;
+    pid_t pid;      // Game running with --preview, -1 once the cache is full
+    int fd;         // Read end of its stdout
+    char (*frames)[PREVIEW_ROWS][PREVIEW_COLS + 1];
+    int frame_count;
+    int shown;      // Frame to show next
+    int drawn;      // Frame currently on screen
+    int row;        // Row being filled in the incoming frame
+    int col;
+};
 
 // Global variables
 struct termios orig_termios;
@@ -18,6 +51,20 @@ int game_count = 0;
 int selected_game = 0; // Tracks the selected game
 int is_exit_selected = 0; // Tracks whether the Exit button is selected
 pid_t child_pid = -1;    // Track the child process ID
+int terminal_saved = 0;
+
+// Games kept resident between sessions, indexed like games[]
+pid_t game_pids[MAX_GAMES];                 // -1 when the game is not running
+struct termios game_termios[MAX_GAMES];     // Terminal settings saved when it was parked
+struct game_status *status_pages[MAX_GAMES]; // Shared status page written by the game
+int status_fds[MAX_GAMES];
+int game_hung[MAX_GAMES];
+struct session_sampler sessions[MAX_GAMES];  // Resource use of the running session
+struct rusage game_usage[MAX_GAMES];         // Filled in by wait4() when the game exits
+int game_exit_status[MAX_GAMES];
+struct preview previews[MAX_GAMES];
+int menu_idle = 0;       // Previews are paused after IDLE_TIMEOUT without input
+int jitter_games = 0;    // Pass --jitter on to launched games
 
 // Function Prototypes
 void reset_terminal();
@@ -25,9 +72,24 @@ void setup_terminal();
 void ensure_terminal_reset();
 void handle_signal(int sig);
 void display_main_screen();
-void launch_game(const char *game);
-int kbhit();
+void launch_game(int index);
+int wait_foreground(int index);
+void park_game(int index);
+void end_game(int index);
+void kill_resident_games();
+void display_game_status(int index);
 void scan_games();
+void display_top_scores(const char *game);
+void display_session_stats();
+void display_preview();
+void start_preview(int index);
+void pause_preview(int index);
+void resume_preview(int index);
+void read_preview(struct preview *p);
+void stop_previews();
+void animate_preview();
+void change_game(int step);
+long long now_us();
 
 // Reset terminal to its original settings
 void reset_terminal() {
@@ -44,16 +106,15 @@ void ensure_terminal_reset() {
 
 void handle_signal(int sig) {
     if (child_pid > 0) {
-        // Child process (game) is running, terminate it
+        // Child process (game) is running, terminate it; wait_foreground() reaps it
         printf("\nGame interrupted. Returning to main menu...\n");
         kill(child_pid, SIGKILL);  // Force terminate the child process
-        waitpid(child_pid, NULL, 0); // Wait for the child process to terminate
-        child_pid = -1;  // Reset the child process ID
-        display_main_screen();  // Return to the main menu
     } else {
         // Parent process: exit gracefully if no child is running
         if (sig == SIGINT || sig == SIGTERM) {
             printf("\nExiting main menu gracefully...\n");
+            stop_previews();
+            kill_resident_games();
             ensure_terminal_reset();
             exit(0);
         }
@@ -63,26 +124,22 @@ void handle_signal(int sig) {
 // Setup terminal for non-canonical input
 void setup_terminal() {
     struct termios new_termios;
-    tcgetattr(STDIN_FILENO, &orig_termios); // Get original terminal settings
-    atexit(ensure_terminal_reset);         // Ensure terminal reset on exit
-    signal(SIGINT, handle_signal);         // Handle "Ctrl+C"
-    signal(SIGTERM, handle_signal);        // Handle termination
+    if (!terminal_saved) {
+        // Only the first call sees the user's settings; later ones may follow a parked game
+        tcgetattr(STDIN_FILENO, &orig_termios); // Get original terminal settings
+        atexit(ensure_terminal_reset);         // Ensure terminal reset on exit
+        signal(SIGINT, handle_signal);         // Handle "Ctrl+C"
+        signal(SIGTERM, handle_signal);        // Handle termination
+        signal(SIGTSTP, SIG_IGN);              // The menu itself is never suspended
+        signal(SIGTTOU, SIG_IGN);              // Allows taking the terminal back from a game
+        terminal_saved = 1;
+    }
 
     new_termios = orig_termios;
     new_termios.c_lflag &= ~(ICANON | ECHO); // Disable canonical mode and echoing
     tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
 }
 
-// Non-blocking input
-int kbhit() {
-    struct timeval tv = {0, 0};
-    fd_set fds;
-    FD_ZERO(&fds);
-    FD_SET(STDIN_FILENO, &fds);
-    select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv);
-    return FD_ISSET(STDIN_FILENO, &fds);
-}
-
 // Scan the current directory for executable game files starting with "game_"
 void scan_games() {
     struct dirent *entry;
@@ -108,7 +165,7 @@ void scan_games() {
 
 // Display the main menu
 void display_main_screen() {
-    system("clear");
+    printf("\033[H\033[J"); // Clear without forking a shell, the menu redraws often
     printf("\n=== Welcome to main-screen ===\n\n");
 
     int padding = 20 - strlen(games[selected_game]);
@@ -128,48 +185,458 @@ void display_main_screen() {
         printf("  Exit\n");
     }
 
+    display_game_status(selected_game);
+    display_top_scores(games[selected_game] + 5);
+
     printf("\nUse 'w' and 's' to change game.\n");
     printf("Use 'a' and 'd' to select Exit.\n");
     printf("Press 'Enter' to confirm.\n");
+    printf("Press Ctrl+Z in a game to come back here;\n");
+    printf("'k' ends the suspended game.\n"); // Menu lines stay left of the preview
+    printf("Press 't' for resource statistics.\n");
+
+    display_preview();
 }
 
-// Launch the selected game using fork and exec
-void launch_game(const char *game) {
-    child_pid = fork();
+// Show the best scores for a game straight from the shared leaderboard
+void display_top_scores(const char *game) {
+    struct hs_entry top[TOP_SCORES_SHOWN];
+
+    // The file only appears once some game has submitted a score
+    if (hs_open(0) < 0) return;
+
+    int n = hs_top(game, top, TOP_SCORES_SHOWN);
+    if (n == 0) return;
+
+    printf("\n  Top scores:\n");
+    for (int i = 0; i < n; i++) {
+        char date[16];
+        time_t when = (time_t)top[i].hour * 3600;
+        strftime(date, sizeof(date), "%Y-%m-%d", localtime(&when));
+        printf("    %d. %-8u %s\n", i + 1, top[i].score, date);
+    }
+}
+
+int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Value at fraction q of a sorted array
+double percentile(const double *sorted, int n, double q) {
+    return sorted[(int)(q * (n - 1) + 0.5)];
+}
+
+// Per-title resource use from the session history
+void display_session_stats() {
+    struct session_record *recs;
+    int count = session_load(&recs);
+
+    printf("\033[H\033[J");
+    printf("\n=== Resource statistics (last %d sessions) ===\n\n", count);
+    printf("  CPU%% is CPU time over time in the foreground; 'recent' is the last %d sessions.\n", RECENT_SESSIONS);
+    printf("  RSS in MB: 'mean' is sampled while the game runs, 'max' is its peak from wait4().\n\n");
+    printf("  %-14s %5s %8s %7s %7s %7s %7s %8s %7s %7s %7s %7s\n", "game", "runs", "cpu% avg", "p50", "p90",
+           "recent", "peak", "mean rss", "max rss", "max p90", "csw/s", "wall s");
+
+    double *cpu = malloc(sizeof(double) * (count ? count : 1));
+    double *rss = malloc(sizeof(double) * (count ? count : 1));
+    for (int g = 0; g < game_count && cpu && rss; g++) {
+        const char *name = games[g] + 5;
+        int n = 0;
+        double cpu_sum = 0, mean_rss_sum = 0, max_rss_sum = 0, recent_sum = 0, switches = 0, active_s = 0, wall_s = 0;
+        int recent = 0;
+        uint32_t peak = 0; // Busiest second seen in any session, from /proc sampling
+
+        // Newest first, so the recent column is the first sessions found
+        for (int i = count - 1; i >= 0; i--) {
+            const struct session_record *r = &recs[i];
+            if (strncmp(r->game, name, sizeof(r->game)) != 0) continue;
+            double active = r->active_ms > 0 ? r->active_ms : 1;
+            cpu[n] = 100.0 * (r->user_ms + r->sys_ms) / active;
+            rss[n] = r->max_rss_kb / 1024.0; // Max RSS, for its percentile
+            cpu_sum += cpu[n];
+            mean_rss_sum += r->mean_rss_kb / 1024.0;
+            max_rss_sum += rss[n];
+            if (recent < RECENT_SESSIONS) {
+                recent_sum += cpu[n];
+                recent++;
+            }
+            if (r->peak_cpu_permille > peak) peak = r->peak_cpu_permille;
+            switches += r->voluntary_switches + r->involuntary_switches;
+            active_s += r->active_ms / 1000.0;
+            wall_s += r->wall_ms / 1000.0;
+            n++;
+        }
+        if (n == 0) continue;
+
+        qsort(cpu, n, sizeof(double), compare_double);
+        qsort(rss, n, sizeof(double), compare_double);
+        printf("  %-14s %5d %8.1f %7.1f %7.1f %7.1f %7.1f %8.1f %7.1f %7.1f %7.1f %7.1f\n", name, n, cpu_sum / n,
+               percentile(cpu, n, 0.5), percentile(cpu, n, 0.9), recent_sum / recent, peak / 10.0,
+               mean_rss_sum / n, max_rss_sum / n, percentile(rss, n, 0.9),
+               active_s > 0 ? switches / active_s : 0.0, wall_s / n);
+    }
+    free(cpu);
+    free(rss);
+    free(recs);
+
+    if (count == 0) printf("\n  No sessions recorded yet.\n");
+    printf("\nPress any key to return.\n");
+    fflush(stdout);
+}
+
+// Draw the selected game's current preview frame to the right of the menu
+void display_preview() {
+    struct preview *p = &previews[selected_game];
+    if (p->frame_count == 0 || game_pids[selected_game] > 0) return;
+
+    for (int r = 0; r < PREVIEW_ROWS; r++) {
+        // Pad to the preview's own width rather than clearing to the end of the line
+        printf("\033[%d;%dH%-*s", r + 2, PREVIEW_SCREEN_COL, PREVIEW_COLS, p->frames[p->shown][r]);
+    }
+    fflush(stdout);
+    p->drawn = p->shown;
+}
+
+// Advance the selected preview by one tick, redrawing only the preview area
+void animate_preview() {
+    struct preview *p = &previews[selected_game];
+
+    if (p->state == PREVIEW_CACHED) {
+        p->shown = (p->shown + 1) % p->frame_count;
+    }
+    if (p->frame_count > 0 && p->shown != p->drawn) {
+        display_preview();
+    }
+}
+
+// Move the selection, stepping only the selected game's simulation
+void change_game(int step) {
+    pause_preview(selected_game);
+    selected_game = (selected_game + step + game_count) % game_count;
+    resume_preview(selected_game);
+    display_main_screen();
+}
+
+// Monotonic clock in microseconds
+long long now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Run the game headless with its stdout connected to a pipe we read frames from
+void start_preview(int index) {
+    struct preview *p = &previews[index];
+    int fds[2];
+
+    p->frames = calloc(PREVIEW_FRAMES, sizeof(*p->frames));
+    if (!p->frames || pipe(fds) < 0) {
+        p->state = PREVIEW_FAILED;
+        return;
+    }
+
+    p->pid = fork();
+    if (p->pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        p->state = PREVIEW_FAILED;
+        return;
+    } else if (p->pid == 0) {
+        // Own process group, so terminal signals meant for the menu or a game never reach it
+        setpgid(0, 0);
+        int devnull = open("/dev/null", O_RDWR);
+        dup2(devnull, STDIN_FILENO);
+        dup2(fds[1], STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(fds[0]);
+        close(fds[1]);
 
-    if (child_pid < 0) {
-        perror("Fork failed");
-        exit(1);
-    } else if (child_pid == 0) {
-        // Child process: launch the game
-        reset_terminal();          // Reset terminal in child process
         char game_path[256];
-        snprintf(game_path, sizeof(game_path), "./%s", game); // Build path to the game
-        execlp(game_path, game, NULL); // Execute the game
-        perror("Failed to launch game"); // Handle execlp failure
-        exit(1); // Exit the child process
+        snprintf(game_path, sizeof(game_path), "./%s", games[index]);
+        execl(game_path, games[index], "--preview", NULL);
+        _exit(1);
+    }
+
+    close(fds[1]);
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC); // Games launched later must not inherit it
+    p->fd = fds[0];
+    p->drawn = -1;
+    p->state = PREVIEW_FILLING;
+}
+
+// Stop stepping a preview simulation while its entry is not selected
+void pause_preview(int index) {
+    if (previews[index].state == PREVIEW_FILLING) {
+        kill(previews[index].pid, SIGSTOP);
+    }
+}
+
+void resume_preview(int index) {
+    if (game_pids[index] > 0) {
+        return; // A suspended game shows its live status instead
+    } else if (previews[index].state == PREVIEW_NONE) {
+        start_preview(index);
+    } else if (previews[index].state == PREVIEW_FILLING) {
+        kill(previews[index].pid, SIGCONT);
+    }
+}
+
+// Drain available output into the frame cache; the simulation ends once the cache is full
+void read_preview(struct preview *p) {
+    char buf[4096];
+    ssize_t n;
+
+    while ((n = read(p->fd, buf, sizeof(buf))) > 0) {
+        for (ssize_t i = 0; i < n && p->frame_count < PREVIEW_FRAMES; i++) {
+            char (*frame)[PREVIEW_COLS + 1] = p->frames[p->frame_count];
+
+            if (buf[i] != '\n') {
+                if (p->row < PREVIEW_ROWS && p->col < PREVIEW_COLS) {
+                    frame[p->row][p->col++] = buf[i];
+                }
+            } else if (p->col > 0) {
+                p->row++; // End of a row
+                p->col = 0;
+            } else if (p->row > 0) {
+                p->shown = p->frame_count++; // Blank line: the frame is complete
+                p->row = 0;
+            }
+        }
+        if (p->frame_count == PREVIEW_FRAMES) break;
+    }
+
+    if (n == 0 || p->frame_count == PREVIEW_FRAMES) {
+        // Cache is full (or the game went away): loop the cached frames from now on
+        kill(p->pid, SIGKILL);
+        waitpid(p->pid, NULL, 0);
+        close(p->fd);
+        p->pid = -1;
+        p->state = p->frame_count > 0 ? PREVIEW_CACHED : PREVIEW_FAILED;
+    }
+}
+
+void stop_previews() {
+    for (int i = 0; i < game_count; i++) {
+        if (previews[i].state == PREVIEW_FILLING) {
+            kill(previews[i].pid, SIGKILL);
+            waitpid(previews[i].pid, NULL, 0);
+            previews[i].state = PREVIEW_NONE;
+        }
+    }
+}
+
+// Show whether a game is resident, with the live status it publishes
+void display_game_status(int index) {
+    if (game_pids[index] <= 0) return;
+
+    struct game_status *st = status_pages[index];
+    printf("\n  Suspended");
+    if (st && atomic_load(&st->heartbeat) > 0) {
+        printf(" at tick %llu, score %d", (unsigned long long)atomic_load(&st->heartbeat),
+               atomic_load(&st->score));
+    }
+    if (game_hung[index]) {
+        printf(" (not responding)");
+    }
+    printf("\n");
+
+    printf("  Resident:");
+    for (int i = 0; i < game_count; i++) {
+        if (game_pids[i] > 0) printf(" %s", games[i] + 5);
+    }
+    printf("\n");
+}
+
+// Launch the selected game using fork and exec, or resume it if it is parked
+void launch_game(int index) {
+    pause_preview(selected_game);
+
+    if (game_pids[index] > 0) {
+        // Resume a parked game: its terminal settings, the terminal itself, then the process
+        printf("\033[H\033[J");
+        fflush(stdout);
+        tcsetattr(STDIN_FILENO, TCSANOW, &game_termios[index]);
+        tcsetpgrp(STDIN_FILENO, game_pids[index]);
+        kill(-game_pids[index], SIGCONT);
     } else {
-        // Parent process: wait for the child process to finish
+        status_pages[index] = game_status_create(&status_fds[index]);
+        session_begin(&sessions[index]);
+        game_pids[index] = fork();
+
+        if (game_pids[index] < 0) {
+            perror("Fork failed");
+            exit(1);
+        } else if (game_pids[index] == 0) {
+            // Child process: launch the game in its own job so it can be stopped and resumed alone
+            setpgid(0, 0);
+            tcsetpgrp(STDIN_FILENO, getpid());
+            signal(SIGTSTP, SIG_DFL);
+            signal(SIGTTOU, SIG_DFL);
+            reset_terminal();          // Reset terminal in child process
+
+            if (status_pages[index]) {
+                char fd_text[16];
+                fcntl(status_fds[index], F_SETFD, 0); // Let this page survive exec
+                snprintf(fd_text, sizeof(fd_text), "%d", status_fds[index]);
+                setenv(GAME_STATUS_ENV, fd_text, 1);
+            }
+
+            char game_path[256];
+            snprintf(game_path, sizeof(game_path), "./%s", games[index]); // Build path to the game
+            char *game_argv[4] = {games[index], NULL, NULL, NULL};
+            int game_argc = 1;
+            if (rt_enabled()) game_argv[game_argc++] = "--rt"; // Games set up their own real-time mode
+            if (jitter_games) game_argv[game_argc++] = "--jitter";
+            execvp(game_path, game_argv); // Execute the game
+            perror("Failed to launch game"); // Handle execvp failure
+            exit(1); // Exit the child process
+        }
+
+        // Parent process: same job setup as the child, whichever runs first
+        setpgid(game_pids[index], game_pids[index]);
+        tcsetpgrp(STDIN_FILENO, game_pids[index]);
+    }
+
+    child_pid = game_pids[index];
+    if (wait_foreground(index)) {
+        park_game(index);
+    } else {
+        end_game(index);
+    }
+    child_pid = -1; // Reset the child process ID
+
+    // Take the terminal back for the menu
+    tcsetpgrp(STDIN_FILENO, getpgrp());
+    // now we need to update the title of the console
+    printf("%c]0;%s%c", '\033', "main-screen", '\007');
+    setup_terminal(); // Reconfigure the terminal for the main menu
+    resume_preview(selected_game);
+    display_main_screen(); // Re-display the main menu
+}
+
+// Wait while a game has the terminal; returns 1 if it stopped, 0 if it ended
+int wait_foreground(int index) {
+    pid_t pid = game_pids[index];
+    long long resumed_us = now_us();
+    game_hung[index] = 0;
+    session_resume(&sessions[index]);
+
+    while (1) {
         int status;
-        waitpid(child_pid, &status, 0); // Wait for the game process to complete
-        // now we need to update the title of the console
-        printf("%c]0;%s%c", '\033', "main-screen", '\007');
-        child_pid = -1; // Reset the child process ID
-        setup_terminal(); // Reconfigure the terminal for the main menu
-        display_main_screen(); // Re-display the main menu
+        pid_t r = wait4(pid, &status, WUNTRACED | WNOHANG, &game_usage[index]);
+        if (r == pid) {
+            session_pause(&sessions[index]);
+            game_exit_status[index] = status;
+            return WIFSTOPPED(status);
+        }
+        if (r < 0 && errno != EINTR) {
+            session_pause(&sessions[index]);
+            return 0;
+        }
+        session_sample(&sessions[index], pid);
+
+        // A running game must keep ticking; one that stops is suspended and flagged
+        struct game_status *st = status_pages[index];
+        if (st && atomic_load(&st->state) == GS_RUNNING) {
+            long long beat_us = atomic_load(&st->last_beat_ns) / 1000;
+            long long since_us = now_us() - (beat_us > resumed_us ? beat_us : resumed_us);
+            if (since_us > HUNG_TIMEOUT_US && !game_hung[index]) {
+                game_hung[index] = 1;
+                kill(-pid, SIGSTOP);
+            }
+        }
+
+        usleep(FOREGROUND_POLL_US);
+    }
+}
+
+// Keep a stopped game resident, remembering its terminal settings for when it resumes
+void park_game(int index) {
+    tcgetattr(STDIN_FILENO, &game_termios[index]);
+}
+
+// Record the finished session and forget a game that has exited
+void end_game(int index) {
+    session_end(&sessions[index], games[index] + 5, game_exit_status[index], &game_usage[index]);
+    game_status_destroy(status_pages[index], status_fds[index]);
+    status_pages[index] = NULL;
+    status_fds[index] = -1;
+    game_pids[index] = -1;
+    game_hung[index] = 0;
+}
+
+void kill_resident_games() {
+    for (int i = 0; i < game_count; i++) {
+        if (game_pids[i] > 0) {
+            kill(-game_pids[i], SIGKILL);
+            wait4(game_pids[i], &game_exit_status[i], 0, &game_usage[i]);
+            end_game(i);
+        }
     }
 }
 
 // Main function
 int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rt") == 0) rt_open();
+        if (strcmp(argv[i], "--jitter") == 0) {
+            jitter_open(); // The menu's animation tick gets a report of its own
+            jitter_games = 1;
+        }
+    }
+
     printf("%c]0;%s%c", '\033', "main-screen", '\007');
     setup_terminal();
     scan_games();
+    for (int i = 0; i < game_count; i++) {
+        game_pids[i] = -1;
+        status_fds[i] = -1;
+    }
+    resume_preview(selected_game);
     display_main_screen();
+    rt_lock_memory();
+
+    long long last_input_us = now_us();
+    long long next_frame_us = last_input_us + PREVIEW_INTERVAL_US;
 
     while (1) {
-        if (kbhit()) {
-            char input = getchar();
+        struct preview *p = &previews[selected_game];
+        int preview_fd = (!menu_idle && p->state == PREVIEW_FILLING) ? p->fd : -1;
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(STDIN_FILENO, &fds);
+        if (preview_fd >= 0) FD_SET(preview_fd, &fds);
+
+        // Sleep until a key, preview output or the next animation tick; an idle menu waits for keys only
+        struct timeval tv;
+        struct timeval *timeout = NULL;
+        if (!menu_idle) {
+            long long wait_us = next_frame_us - now_us();
+            if (wait_us < 0) wait_us = 0;
+            tv.tv_sec = wait_us / 1000000;
+            tv.tv_usec = wait_us % 1000000;
+            timeout = &tv;
+        }
+        int max_fd = preview_fd > STDIN_FILENO ? preview_fd : STDIN_FILENO;
+        if (select(max_fd + 1, &fds, NULL, NULL, timeout) < 0) {
+            continue; // Interrupted by a signal
+        }
+
+        if (preview_fd >= 0 && FD_ISSET(preview_fd, &fds)) {
+            read_preview(p);
+        }
+
+        char input;
+        if (FD_ISSET(STDIN_FILENO, &fds) && read(STDIN_FILENO, &input, 1) == 1) {
+            last_input_us = now_us();
+            if (menu_idle) {
+                menu_idle = 0;
+                resume_preview(selected_game);
+                next_frame_us = last_input_us;
+            }
 
             switch (input) {
                 case 'q': // Quit the main menu
@@ -177,16 +644,32 @@ int main(int argc, char *argv[]) {
                     break;
                 case 'w': // Move up in the game list
                     if (!is_exit_selected) {
-                        selected_game = (selected_game - 1 + game_count) % game_count;
-                        display_main_screen();
+                        change_game(-1);
                     }
                     break;
                 case 's': // Move down in the game list
                     if (!is_exit_selected) {
-                        selected_game = (selected_game + 1) % game_count;
+                        change_game(1);
+                    }
+                    break;
+                case 'k': // End the selected game if it is suspended
+                    if (!is_exit_selected && game_pids[selected_game] > 0) {
+                        kill(-game_pids[selected_game], SIGKILL);
+                        wait4(game_pids[selected_game], &game_exit_status[selected_game], 0,
+                              &game_usage[selected_game]);
+                        end_game(selected_game);
+                        resume_preview(selected_game);
                         display_main_screen();
                     }
                     break;
+                case 't': // Resource statistics until a key is pressed
+                    pause_preview(selected_game);
+                    display_session_stats();
+                    read(STDIN_FILENO, &input, 1);
+                    resume_preview(selected_game);
+                    display_main_screen();
+                    last_input_us = now_us();
+                    break;
                 case 'a': // Select Exit
                     is_exit_selected = !is_exit_selected;
                     display_main_screen();
@@ -199,13 +682,25 @@ int main(int argc, char *argv[]) {
                     if (is_exit_selected) {
                         handle_signal(SIGTERM); // Exit the main menu
                     } else {
-                        launch_game(games[selected_game]);
+                        launch_game(selected_game);
+                        last_input_us = now_us();
                     }
                     break;
             }
         }
 
-        usleep(100000); // Smooth game loop
+        long long now = now_us();
+        if (!menu_idle && now >= next_frame_us) {
+            jitter_tick(next_frame_us * 1000, PREVIEW_INTERVAL_US * 1000LL);
+            animate_preview();
+            next_frame_us += PREVIEW_INTERVAL_US;
+            if (next_frame_us < now) next_frame_us = now + PREVIEW_INTERVAL_US;
+
+            if (now - last_input_us > IDLE_TIMEOUT * 1000000LL) {
+                menu_idle = 1; // Keep the last frame on screen and stop using CPU
+                pause_preview(selected_game);
+            }
+        }
     }
 
     return 0;
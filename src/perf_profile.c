@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "perf_profile.h"
+
+#define PROF_MAX_TICKS 65536 // Per-tick samples kept for percentiles; totals keep counting past it
+
+enum { EV_CYCLES, EV_INSTRUCTIONS, EV_BRANCH_MISSES, EV_L1D_MISSES, EV_LLC_MISSES, EV_COUNT };
+#define EV_NS EV_COUNT              // Wall time is stored after the counters,
+#define EV_ENABLED (EV_COUNT + 1)   // then how long the group was enabled
+#define EV_RUNNING (EV_COUNT + 2)   // and how long it was actually on the PMU
+#define SAMPLE_WIDTH (EV_COUNT + 3)
+
+#define CACHE_READ_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+} events[EV_COUNT] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branch misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"L1D misses", PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D)},
+    {"LLC misses", PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL)},
+};
+
+static const char *phase_names[PROF_PHASES] = {"simulate", "render"};
+
+static int enabled = 0;
+static int group_fd = -1;
+static int event_slot[EV_COUNT]; // Position in the group read, -1 if the event is unsupported
+static int group_size = 0;
+static char fallback_reason[128] = "";
+
+static uint64_t phase_start[PROF_PHASES][SAMPLE_WIDTH];
+static uint64_t phase_total[PROF_PHASES][SAMPLE_WIDTH];
+static uint64_t *phase_samples[PROF_PHASES]; // PROF_MAX_TICKS rows of SAMPLE_WIDTH values
+static long phase_ticks[PROF_PHASES];
+static long phase_counted[PROF_PHASES];     // Ticks the group ran for at all
+static long phase_multiplexed[PROF_PHASES]; // Counted ticks that ran only part of the time, scaled up
+
+static void prof_report();
+
+static int perf_event_open(struct perf_event_attr *attr, int group) {
+    return (int)syscall(SYS_perf_event_open, attr, 0, -1, group, 0);
+}
+
+// Open every event in one group led by cycles, skipping the ones this CPU or VM lacks
+static void open_counters() {
+    for (int e = 0; e < EV_COUNT; e++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[e].type;
+        attr.config = events[e].config;
+        // The times show when the PMU could not fit the group and it was multiplexed or never ran
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1; // Allowed at the default perf_event_paranoid level
+        attr.exclude_hv = 1;
+
+        int fd = perf_event_open(&attr, group_fd);
+        event_slot[e] = -1;
+
+        if (fd < 0) {
+            if (e == EV_CYCLES) {
+                // Without a leader there is no group at all
+                snprintf(fallback_reason, sizeof(fallback_reason), "%s", strerror(errno));
+                return;
+            }
+            continue;
+        }
+        if (group_fd < 0) group_fd = fd;
+        event_slot[e] = group_size++;
+    }
+}
+
+static void read_sample(uint64_t *out) {
+    struct {
+        uint64_t nr;
+        uint64_t time_enabled, time_running;
+        uint64_t values[EV_COUNT];
+    } data;
+
+    memset(out, 0, sizeof(uint64_t) * SAMPLE_WIDTH);
+    if (group_fd >= 0 && read(group_fd, &data, sizeof(data)) > 0) {
+        for (int e = 0; e < EV_COUNT; e++) {
+            if (event_slot[e] >= 0) out[e] = data.values[event_slot[e]];
+        }
+        out[EV_ENABLED] = data.time_enabled;
+        out[EV_RUNNING] = data.time_running;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    out[EV_NS] = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void prof_open() {
+    for (int p = 0; p < PROF_PHASES; p++) {
+        phase_samples[p] = malloc(sizeof(uint64_t) * SAMPLE_WIDTH * PROF_MAX_TICKS);
+        if (!phase_samples[p]) {
+            perror("Profiler allocation failed");
+            return;
+        }
+    }
+
+    open_counters();
+    enabled = 1;
+    atexit(prof_report);
+}
+
+void prof_begin(int phase) {
+    if (!enabled) return;
+    read_sample(phase_start[phase]);
+}
+
+void prof_end(int phase) {
+    if (!enabled) return;
+
+    uint64_t now[SAMPLE_WIDTH];
+    read_sample(now);
+
+    long tick = phase_ticks[phase]++;
+    uint64_t enabled_ns = now[EV_ENABLED] - phase_start[phase][EV_ENABLED];
+    uint64_t running_ns = now[EV_RUNNING] - phase_start[phase][EV_RUNNING];
+    if (running_ns > 0) phase_counted[phase]++;
+    if (running_ns > 0 && running_ns < enabled_ns) phase_multiplexed[phase]++;
+
+    for (int i = 0; i < SAMPLE_WIDTH; i++) {
+        uint64_t delta = now[i] - phase_start[phase][i];
+        // Estimate the full count from the share of the tick the group was on the PMU
+        if (i < EV_COUNT && running_ns > 0 && running_ns < enabled_ns) {
+            delta = (uint64_t)((double)delta * enabled_ns / running_ns);
+        }
+        phase_total[phase][i] += delta;
+        if (tick < PROF_MAX_TICKS) phase_samples[phase][tick * SAMPLE_WIDTH + i] = delta;
+    }
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Percentiles of one column of a phase's samples, sorted in place into scratch.
+// Counter columns leave out ticks the group never ran in, whose counts read as 0.
+static void percentiles(int phase, int column, uint64_t *scratch, uint64_t out[4]) {
+    long ticks = phase_ticks[phase] < PROF_MAX_TICKS ? phase_ticks[phase] : PROF_MAX_TICKS;
+    static const int pct[3] = {50, 90, 99};
+
+    long n = 0;
+    for (long t = 0; t < ticks; t++) {
+        const uint64_t *sample = &phase_samples[phase][t * SAMPLE_WIDTH];
+        if (column < EV_COUNT && sample[EV_RUNNING] == 0) continue;
+        scratch[n++] = sample[column];
+    }
+    qsort(scratch, n, sizeof(uint64_t), compare_u64);
+
+    for (int i = 0; i < 3; i++) {
+        out[i] = n ? scratch[(n - 1) * pct[i] / 100] : 0;
+    }
+    out[3] = n ? scratch[n - 1] : 0;
+}
+
+// Print the per-phase summary
+static void prof_report() {
+    static uint64_t scratch[PROF_MAX_TICKS];
+    static const char *pct_names[4] = {"p50", "p90", "p99", "max"};
+    uint64_t pct[PROF_PHASES][4];
+
+    printf("\nProfile summary (%ld ticks)\n", phase_ticks[PROF_SIMULATE]);
+    if (group_fd < 0) {
+        printf("Hardware counters unavailable (%s); wall time only.\n", fallback_reason);
+    }
+    for (int p = 0; p < PROF_PHASES && group_fd >= 0; p++) {
+        if (phase_ticks[p] > 0 && phase_counted[p] == 0) {
+            printf("Counters not scheduled during %s (PMU busy or not available to this VM).\n", phase_names[p]);
+        } else if (phase_counted[p] < phase_ticks[p] || phase_multiplexed[p] > 0) {
+            printf("Counters multiplexed during %s: %ld of %ld ticks scaled, %ld not counted.\n", phase_names[p],
+                   phase_multiplexed[p], phase_ticks[p], phase_ticks[p] - phase_counted[p]);
+        }
+    }
+    printf("%-22s %14s %14s\n", "", phase_names[PROF_SIMULATE], phase_names[PROF_RENDER]);
+
+    for (int e = 0; e < EV_COUNT && group_fd >= 0; e++) {
+        printf("%-22s", events[e].name);
+        for (int p = 0; p < PROF_PHASES; p++) {
+            if (event_slot[e] < 0 || phase_counted[p] == 0) {
+                printf(" %14s", "n/a");
+            } else {
+                printf(" %14.1f", (double)phase_total[p][e] / phase_counted[p]);
+            }
+        }
+        printf("   per tick\n");
+    }
+
+    if (group_fd >= 0 && event_slot[EV_INSTRUCTIONS] >= 0) {
+        printf("%-22s", "IPC");
+        for (int p = 0; p < PROF_PHASES; p++) {
+            double cycles = (double)phase_total[p][EV_CYCLES];
+            if (cycles > 0) {
+                printf(" %14.2f", phase_total[p][EV_INSTRUCTIONS] / cycles);
+            } else {
+                printf(" %14s", "n/a");
+            }
+        }
+        printf("\n");
+    }
+
+    // Latency distribution: cycles when counted, microseconds always
+    int columns[2] = {EV_CYCLES, EV_NS};
+    for (int c = group_fd >= 0 ? 0 : 1; c < 2; c++) {
+        for (int p = 0; p < PROF_PHASES; p++) {
+            percentiles(p, columns[c], scratch, pct[p]);
+        }
+        for (int i = 0; i < 4; i++) {
+            char label[32];
+            snprintf(label, sizeof(label), "%s %s", c == 0 ? "cycles" : "usec", pct_names[i]);
+            printf("%-22s", label);
+            for (int p = 0; p < PROF_PHASES; p++) {
+                if (c == 0 && phase_counted[p] == 0) {
+                    printf(" %14s", "n/a");
+                } else if (c == 0) {
+                    printf(" %14llu", (unsigned long long)pct[p][i]);
+                } else {
+                    printf(" %14.1f", pct[p][i] / 1000.0);
+                }
+            }
+            printf("\n");
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef PERF_PROFILE_H
+#define PERF_PROFILE_H
+
+// Phases of a game tick measured by --profile
+#define PROF_SIMULATE 0
+#define PROF_RENDER 1
+#define PROF_PHASES 2
+
+// Start profiling: opens hardware counters where the kernel allows it and
+// falls back to wall time otherwise. The summary is printed at exit.
+void prof_open();
+
+// Bracket one phase of a tick. No-ops unless prof_open() was called.
+void prof_begin(int phase);
+void prof_end(int phase);
+
+#endif
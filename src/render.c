@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include "render.h"
+#include "frame_ring.h"
+#include "rt_mode.h"
+
+#define MAX_CLASSES 8   // Blank plus up to seven drawn cell kinds
+#define MAX_ATTR 32     // Longest attribute sequence: "\033[0;38;5;NNN;48;5;NNNm"
+#define MAX_FOOTER 64   // Footer length render_prepare() allows for
+
+static enum render_mode mode = RENDER_TEXT;
+static int use_color = 0;
+static int first_frame = 1;
+
+static uint8_t cell_class[256];          // Cell character -> class, 0 is blank
+static uint8_t class_color[MAX_CLASSES];
+static int class_count = 1;
+
+// Precomputed glyphs: braille by dot mask, half blocks by (top, bottom) bits
+static char braille_glyph[256][4];
+static const char *half_glyph[4] = {" ", "▀", "▄", "█"};
+
+// Precomputed attribute sequences by (foreground class, background class)
+static char attr_seq[MAX_CLASSES][MAX_CLASSES][MAX_ATTR];
+
+static char *frame;
+static size_t frame_size = 0;
+
+int render_parse_mode(const char *name) {
+    if (strcmp(name, "text") == 0) return RENDER_TEXT;
+    if (strcmp(name, "half") == 0) return RENDER_HALF;
+    if (strcmp(name, "braille") == 0) return RENDER_BRAILLE;
+    return -1;
+}
+
+static void build_attr_table() {
+    for (int fg = 0; fg < class_count; fg++) {
+        for (int bg = 0; bg < class_count; bg++) {
+            char *s = attr_seq[fg][bg];
+            int n = snprintf(s, MAX_ATTR, "\033[0");
+            if (fg) n += snprintf(s + n, MAX_ATTR - n, ";38;5;%d", class_color[fg]);
+            if (bg) n += snprintf(s + n, MAX_ATTR - n, ";48;5;%d", class_color[bg]);
+            snprintf(s + n, MAX_ATTR - n, "m");
+        }
+    }
+}
+
+void render_init(enum render_mode new_mode, int color) {
+    mode = new_mode;
+    use_color = color;
+
+    // U+2800 + mask, encoded as three UTF-8 bytes
+    for (int m = 0; m < 256; m++) {
+        int cp = 0x2800 + m;
+        braille_glyph[m][0] = (char)(0xE0 | (cp >> 12));
+        braille_glyph[m][1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        braille_glyph[m][2] = (char)(0x80 | (cp & 0x3F));
+        braille_glyph[m][3] = '\0';
+    }
+    build_attr_table();
+}
+
+void render_palette(char cell, uint8_t color) {
+    if (class_count == MAX_CLASSES) return;
+    class_color[class_count] = color;
+    cell_class[(uint8_t)cell] = class_count++;
+    build_attr_table();
+}
+
+void render_view_size(int lines, int columns, int *rows, int *cols) {
+    switch (mode) {
+        case RENDER_TEXT: *rows = lines; *cols = columns / 2; break;
+        case RENDER_HALF: *rows = lines * 2; *cols = columns; break;
+        case RENDER_BRAILLE: *rows = lines * 4; *cols = columns * 2; break;
+    }
+}
+
+static char *append(char *out, const char *s) {
+    while (*s) *out++ = *s++;
+    return out;
+}
+
+// Switch attributes only when they change, so a run of one colour costs one sequence
+static char *set_attr(char *out, int *current, int fg, int bg) {
+    if (!use_color || *current == fg * MAX_CLASSES + bg) return out;
+    *current = fg * MAX_CLASSES + bg;
+    return append(out, attr_seq[fg][bg]);
+}
+
+static int class_at(const char *cells, int rows, int cols, size_t stride, int r, int c) {
+    if (r >= rows || c >= cols) return 0;
+    return cell_class[(uint8_t)cells[(size_t)r * stride + c]];
+}
+
+// Write the whole buffer, retrying on partial writes
+static void write_all(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        buf += n;
+        len -= n;
+    }
+}
+
+// Grow the frame buffer to hold a frame of rows x cols cells and a footer
+static void reserve_frame(int rows, int cols, size_t footer_len) {
+    // Worst case per character: an attribute change, a glyph and a trailing space
+    size_t needed = (size_t)(rows + 1) * (cols + 1) * (MAX_ATTR + 4) + footer_len + 64;
+    if (needed <= frame_size) return;
+
+    free(frame);
+    frame = malloc(needed);
+    if (!frame) {
+        perror("Frame allocation failed");
+        exit(1);
+    }
+    frame_size = needed;
+    if (rt_enabled()) rt_prefault(frame, frame_size);
+}
+
+void render_prepare(int rows, int cols) {
+    reserve_frame(rows, cols, MAX_FOOTER);
+}
+
+void render_frame(const char *cells, int rows, int cols, size_t stride, const char *footer) {
+    reserve_frame(rows, cols, strlen(footer));
+
+    char *out = frame;
+    out = append(out, first_frame ? "\033[2J\033[H" : "\033[H"); // Redraw in place instead of clearing
+    first_frame = 0;
+    int attr = 0;
+
+    if (mode == RENDER_TEXT) {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                out = set_attr(out, &attr, class_at(cells, rows, cols, stride, r, c), 0);
+                *out++ = cells[(size_t)r * stride + c];
+                *out++ = ' ';
+            }
+            out = set_attr(out, &attr, 0, 0);
+            *out++ = '\n';
+        }
+    } else if (mode == RENDER_HALF) {
+        for (int r = 0; r < rows; r += 2) {
+            for (int c = 0; c < cols; c++) {
+                int top = class_at(cells, rows, cols, stride, r, c);
+                int bottom = class_at(cells, rows, cols, stride, r + 1, c);
+                int bits = (top != 0) | (bottom != 0) << 1;
+                if (bits == 0 && attr % MAX_CLASSES == 0) {
+                    // A blank only needs the background to be right
+                } else if (use_color && top && bottom && top != bottom) {
+                    out = set_attr(out, &attr, top, bottom); // Upper half in front, lower half behind
+                    bits = 1;
+                } else {
+                    out = set_attr(out, &attr, top ? top : bottom, 0);
+                }
+                out = append(out, half_glyph[bits]);
+            }
+            out = set_attr(out, &attr, 0, 0);
+            *out++ = '\n';
+        }
+    } else {
+        static const uint8_t dot[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+        for (int r = 0; r < rows; r += 4) {
+            for (int c = 0; c < cols; c += 2) {
+                int mask = 0, top_class = 0;
+                for (int dr = 0; dr < 4; dr++) {
+                    for (int dc = 0; dc < 2; dc++) {
+                        int k = class_at(cells, rows, cols, stride, r + dr, c + dc);
+                        if (k) mask |= dot[dr][dc];
+                        if (k > top_class) top_class = k; // One colour per character: the highest class
+                    }
+                }
+                if (mask) out = set_attr(out, &attr, top_class, 0); // No dots, no colour needed
+                out = append(out, braille_glyph[mask]);
+            }
+            out = set_attr(out, &attr, 0, 0);
+            *out++ = '\n';
+        }
+    }
+
+    out = append(out, footer);
+    out = append(out, "\033[J"); // Clear whatever a larger previous frame left below
+    fflush(stdout);
+    write_all(frame, out - frame);
+    frame_ring_publish(frame, out - frame); // Spectators get the same bytes
+}
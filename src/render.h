@@ -0,0 +1,34 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// How grid cells are packed into terminal characters
+enum render_mode {
+    RENDER_TEXT,    // One cell per character pair, as "%c " (the classic look)
+    RENDER_HALF,    // Two cells stacked in one half-block character
+    RENDER_BRAILLE, // A 2x4 block of cells in one braille character
+};
+
+// Parse "text", "half" or "braille"; returns -1 for anything else
+int render_parse_mode(const char *name);
+
+// color: use 256-colour attributes for the palette colours
+void render_init(enum render_mode mode, int color);
+
+// Mark a cell character as drawn, in the given 256-colour palette entry. Characters
+// never registered are blank. When cells share a character, the one registered last wins.
+void render_palette(char cell, uint8_t color);
+
+// Grid cells that fit in a screen area of lines x columns characters in this mode
+void render_view_size(int lines, int columns, int *rows, int *cols);
+
+// Allocate the frame buffer for frames of up to rows x cols cells and a short footer,
+// pre-faulted in real-time mode. Call it before rt_lock_memory() so the buffer is locked.
+void render_prepare(int rows, int cols);
+
+// Draw rows x cols cells (stride cells apart per row) and a footer line in one write()
+void render_frame(const char *cells, int rows, int cols, size_t stride, const char *footer);
+
+#endif
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "rng.h"
+
+#define SEED_LOG "seeds.log"
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// SplitMix64 step, used to spread a single seed over the whole state
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(struct rng *r, uint64_t seed) {
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++) {
+        r->s[i] = splitmix64(&x);
+    }
+    r->seed = seed;
+}
+
+uint64_t rng_next(struct rng *r) {
+    uint64_t *s = r->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+// Lemire's multiply-shift reduction with rejection of the biased low range
+uint32_t rng_below(struct rng *r, uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)(rng_next(r) >> 32) * n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t floor = -n % n;
+        while (low < floor) {
+            m = (uint64_t)(uint32_t)(rng_next(r) >> 32) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+uint64_t rng_mask(struct rng *r, int bits, uint8_t threshold) {
+    uint64_t mask = 0;
+    uint64_t draw = 0;
+
+    for (int i = 0; i < bits; i++) {
+        if ((i & 7) == 0) draw = rng_next(r); // One draw covers eight lanes
+        if ((uint8_t)(draw >> ((i & 7) * 8)) < threshold) {
+            mask |= 1ULL << i;
+        }
+    }
+    return mask;
+}
+
+uint64_t rng_seed_from_args(int argc, char *argv[]) {
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "--seed") == 0) {
+            return strtoull(argv[i + 1], NULL, 0);
+        }
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t x = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ ((uint64_t)getpid() << 16);
+    return splitmix64(&x);
+}
+
+void rng_log_seed(const char *game, uint64_t seed) {
+    FILE *log = fopen(SEED_LOG, "a");
+    if (!log) return; // Logging is best effort; the seed is also printed on exit
+
+    fprintf(log, "%ld %s %llu\n", (long)time(NULL), game, (unsigned long long)seed);
+    fclose(log);
+}
@@ -0,0 +1,29 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Explicitly seeded xoshiro256** generator. Each game owns its own state,
+// so runs are reproducible from the seed and simulations can run side by side.
+struct rng {
+    uint64_t s[4];
+    uint64_t seed; // Seed the state was derived from, kept for logging
+};
+
+void rng_seed(struct rng *r, uint64_t seed);
+uint64_t rng_next(struct rng *r);
+
+// Uniform integer in [0, n)
+uint32_t rng_below(struct rng *r, uint32_t n);
+
+// Draw a mask of `bits` independent flags, each set with probability threshold/256.
+// Eight flags come out of every 64-bit draw.
+uint64_t rng_mask(struct rng *r, int bits, uint8_t threshold);
+
+// Seed from "--seed N" on the command line, or from the clock and pid otherwise
+uint64_t rng_seed_from_args(int argc, char *argv[]);
+
+// Append the seed to seeds.log so the run can be replayed with --seed
+void rng_log_seed(const char *game, uint64_t seed);
+
+#endif
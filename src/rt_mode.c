@@ -0,0 +1,215 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <malloc.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include "rt_mode.h"
+
+#define RT_PRIORITY 10          // Above normal tasks, below kernel threads that must not starve
+#define RT_STACK_PREFAULT 262144
+#define JITTER_BUCKETS 18       // Powers of two from 1 us up to 65 ms and beyond
+
+static int rt_on = 0;
+static int jitter_on = 0;
+static char rt_status[3][128];
+
+static int64_t next_deadline = 0;
+static long ticks = 0;
+static long overruns = 0;
+static int64_t late_total = 0;
+static int64_t late_max = 0;
+static long late_histogram[JITTER_BUCKETS];
+
+static void jitter_report();
+static void record_lateness(int64_t late);
+
+static int64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Pin to the highest CPU we may use; low-numbered CPUs tend to take more interrupts
+static void pin_cpu() {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) < 0) {
+        snprintf(rt_status[0], sizeof(rt_status[0]), "affinity: unchanged (%s)", strerror(errno));
+        return;
+    }
+
+    int cpu = CPU_SETSIZE - 1;
+    while (cpu > 0 && !CPU_ISSET(cpu, &allowed)) cpu--;
+
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(cpu, &one);
+    if (sched_setaffinity(0, sizeof(one), &one) < 0) {
+        snprintf(rt_status[0], sizeof(rt_status[0]), "affinity: unchanged (%s)", strerror(errno));
+    } else {
+        snprintf(rt_status[0], sizeof(rt_status[0]), "affinity: CPU %d", cpu);
+    }
+}
+
+// SCHED_FIFO if permitted, else the best nice level we can get
+static void raise_priority() {
+    struct sched_param param = {.sched_priority = RT_PRIORITY};
+
+    // Reset on fork: shells and previews we start must not inherit real-time priority
+    if (sched_setscheduler(0, SCHED_FIFO | SCHED_RESET_ON_FORK, &param) == 0) {
+        snprintf(rt_status[1], sizeof(rt_status[1]), "scheduler: SCHED_FIFO priority %d", RT_PRIORITY);
+        return;
+    }
+
+    int err = errno;
+    if (setpriority(PRIO_PROCESS, 0, -10) == 0) {
+        snprintf(rt_status[1], sizeof(rt_status[1]), "scheduler: SCHED_OTHER nice -10 (FIFO: %s)", strerror(err));
+    } else {
+        snprintf(rt_status[1], sizeof(rt_status[1]), "scheduler: SCHED_OTHER (FIFO: %s)", strerror(err));
+    }
+}
+
+// Size in KB of a /proc/self/status field such as "VmLck:", 0 if it cannot be read
+static long status_kb(const char *field) {
+    FILE *f = fopen("/proc/self/status", "r");
+    if (!f) return 0;
+
+    char line[128];
+    long kb = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, field, strlen(field)) == 0) {
+            kb = atol(line + strlen(field));
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
+
+void rt_lock_memory() {
+    if (!rt_on) return;
+
+    // Grow the stack to its working size first so it is locked too
+    volatile char stack[RT_STACK_PREFAULT];
+    rt_prefault((char *)stack, sizeof(stack));
+
+    // MCL_CURRENT only: with MCL_FUTURE every later allocation would count against
+    // RLIMIT_MEMLOCK and start failing once the limit is reached
+    if (mlockall(MCL_CURRENT) == 0) {
+        snprintf(rt_status[2], sizeof(rt_status[2]), "memory: %ld KB locked", status_kb("VmLck:"));
+        return;
+    }
+
+    int err = errno;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        snprintf(rt_status[2], sizeof(rt_status[2]), "memory: not locked (%s, %ld KB mapped, limit %llu KB)",
+                 strerror(err), status_kb("VmSize:"), (unsigned long long)limit.rlim_cur / 1024);
+    } else {
+        snprintf(rt_status[2], sizeof(rt_status[2]), "memory: not locked (%s)", strerror(err));
+    }
+}
+
+void rt_open() {
+    if (rt_on) return;
+    rt_on = 1;
+    pin_cpu();
+    raise_priority();
+    mallopt(M_TRIM_THRESHOLD, -1); // Keep freed heap memory, so reusing it does not fault again
+    snprintf(rt_status[2], sizeof(rt_status[2]), "memory: not locked");
+    jitter_open();
+}
+
+int rt_enabled() {
+    return rt_on;
+}
+
+void rt_prefault(void *buf, size_t len) {
+    long page = sysconf(_SC_PAGESIZE);
+    volatile char *p = buf;
+    for (size_t i = 0; i < len; i += page) {
+        p[i] = p[i];
+    }
+}
+
+void jitter_open() {
+    if (jitter_on) return;
+    jitter_on = 1;
+    atexit(jitter_report);
+}
+
+void rt_tick_wait(int64_t period_ns) {
+    int64_t now = now_ns();
+    if (next_deadline == 0) next_deadline = now;
+    next_deadline += period_ns;
+    if (next_deadline < now) {
+        // The tick itself overran: restart the schedule instead of rushing to catch up
+        overruns++;
+        next_deadline = now;
+    }
+
+    struct timespec ts = {next_deadline / 1000000000LL, next_deadline % 1000000000LL};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+    if (jitter_on) record_lateness(now_ns() - next_deadline);
+}
+
+void jitter_tick(int64_t deadline_ns, int64_t period_ns) {
+    if (!jitter_on) return;
+
+    int64_t late = now_ns() - deadline_ns;
+    if (late >= period_ns) {
+        overruns++; // Busy elsewhere for a whole period: not a wake-up delay
+        return;
+    }
+    record_lateness(late);
+}
+
+// Add one tick's lateness to the histogram
+static void record_lateness(int64_t late) {
+    if (late < 0) late = 0;
+    int bucket = 0;
+    for (int64_t us = late / 1000; us > 0 && bucket < JITTER_BUCKETS - 1; us >>= 1) bucket++;
+
+    ticks++;
+    late_total += late;
+    if (late > late_max) late_max = late;
+    late_histogram[bucket]++;
+}
+
+// Print the lateness histogram
+static void jitter_report() {
+    printf("\nJitter report (%ld ticks, %s mode)\n", ticks, rt_on ? "real-time" : "normal");
+    for (int i = 0; i < 3 && rt_on; i++) {
+        printf("  %s\n", rt_status[i]);
+    }
+    if (ticks == 0) return;
+
+    printf("  mean lateness %.1f us, max %.1f us, %ld overrun ticks\n",
+           late_total / 1000.0 / ticks, late_max / 1000.0, overruns);
+
+    long peak = 1;
+    for (int b = 0; b < JITTER_BUCKETS; b++) {
+        if (late_histogram[b] > peak) peak = late_histogram[b];
+    }
+    for (int b = 0; b < JITTER_BUCKETS; b++) {
+        if (late_histogram[b] == 0) continue;
+        char range[32];
+        if (b == 0) {
+            snprintf(range, sizeof(range), "< 1 us");
+        } else if (b == JITTER_BUCKETS - 1) {
+            snprintf(range, sizeof(range), ">= %ld us", 1L << (b - 1));
+        } else {
+            snprintf(range, sizeof(range), "%ld-%ld us", 1L << (b - 1), (1L << b) - 1);
+        }
+        int width = (int)(40 * late_histogram[b] / peak);
+        printf("  %14s %8ld %5.1f%% ", range, late_histogram[b], 100.0 * late_histogram[b] / ticks);
+        for (int i = 0; i < width; i++) putchar('#');
+        putchar('\n');
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef RT_MODE_H
+#define RT_MODE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Real-time mode (--rt): pin to one CPU, ask for SCHED_FIFO, lock and pre-fault
+// memory. Every step falls back quietly when the host does not allow it; what was
+// actually granted is listed in the jitter report.
+void rt_open();
+int rt_enabled();
+
+// Lock the pages mapped so far; does nothing outside real-time mode. Call it once the
+// game's buffers are allocated, since memory mapped later is not locked.
+void rt_lock_memory();
+
+// Touch every page of a buffer now rather than on the first frame
+void rt_prefault(void *buf, size_t len);
+
+// Jitter report (--jitter, implied by --rt): tick lateness is recorded by rt_tick_wait()
+// or jitter_tick() and a histogram is printed at exit.
+void jitter_open();
+
+// Sleep until the next tick of a fixed schedule. Deadlines are absolute, so time
+// spent in the tick itself does not stretch the period.
+void rt_tick_wait(int64_t period_ns);
+
+// Record a tick due at deadline_ns (CLOCK_MONOTONIC) that starts now, for loops that do
+// their own waiting. A tick a whole period late counts as an overrun, not as lateness.
+void jitter_tick(int64_t deadline_ns, int64_t period_ns);
+
+#endif
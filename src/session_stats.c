@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include "session_stats.h"
+
+#define SESSION_MAGIC 0x56475353 // "VGSS"
+#define SAMPLE_INTERVAL_US 1000000
+
+struct session_file_header {
+    uint32_t magic;
+    uint32_t capacity;
+    uint64_t total; // Sessions ever written; the next goes to slot total % capacity
+};
+
+static long long monotonic_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void session_begin(struct session_sampler *s) {
+    memset(s, 0, sizeof(*s));
+    s->start_us = monotonic_us();
+}
+
+void session_resume(struct session_sampler *s) {
+    s->resumed_us = monotonic_us();
+}
+
+void session_pause(struct session_sampler *s) {
+    if (s->resumed_us == 0) return;
+    s->active_us += monotonic_us() - s->resumed_us;
+    s->resumed_us = 0;
+}
+
+void session_sample(struct session_sampler *s, pid_t pid) {
+    long long now = monotonic_us();
+    if (now - s->last_sample_us < SAMPLE_INTERVAL_US) return;
+
+    char path[64], buf[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return;
+    buf[n] = '\0';
+
+    // Fields after the parenthesised name, which may itself contain spaces
+    char *p = strrchr(buf, ')');
+    if (!p) return;
+    unsigned long utime, stime;
+    long rss_pages;
+    if (sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %*d %*d %*u %*u %ld",
+               &utime, &stime, &rss_pages) != 3) {
+        return;
+    }
+
+    unsigned long long cpu_ticks = utime + stime;
+    if (s->last_sample_us != 0) {
+        long long elapsed_us = now - s->last_sample_us;
+        uint32_t permille = (cpu_ticks - s->last_cpu_ticks) * 1000000000ULL / sysconf(_SC_CLK_TCK) / elapsed_us;
+        if (permille > s->peak_cpu_permille) s->peak_cpu_permille = permille;
+    }
+    s->last_cpu_ticks = cpu_ticks;
+    s->last_sample_us = now;
+    s->rss_kb_sum += rss_pages * (sysconf(_SC_PAGESIZE) / 1024);
+    s->samples++;
+}
+
+void session_end(struct session_sampler *s, const char *game, int status, const struct rusage *usage) {
+    session_pause(s);
+
+    struct session_record rec;
+    memset(&rec, 0, sizeof(rec));
+    strncpy(rec.game, game, sizeof(rec.game) - 1);
+    long long wall_us = monotonic_us() - s->start_us;
+    rec.start = (uint32_t)(time(NULL) - wall_us / 1000000);
+    rec.wall_ms = wall_us / 1000;
+    rec.active_ms = s->active_us / 1000;
+    rec.user_ms = usage->ru_utime.tv_sec * 1000 + usage->ru_utime.tv_usec / 1000;
+    rec.sys_ms = usage->ru_stime.tv_sec * 1000 + usage->ru_stime.tv_usec / 1000;
+    rec.max_rss_kb = usage->ru_maxrss;
+    rec.mean_rss_kb = s->samples ? s->rss_kb_sum / s->samples : (unsigned long long)usage->ru_maxrss;
+    rec.peak_cpu_permille = s->peak_cpu_permille;
+    rec.voluntary_switches = usage->ru_nvcsw;
+    rec.involuntary_switches = usage->ru_nivcsw;
+    rec.exit_status = WIFSIGNALED(status) ? -WTERMSIG(status) : WEXITSTATUS(status);
+
+    int fd = open(SESSION_FILE, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return; // Statistics are best effort
+    flock(fd, LOCK_EX); // Several consoles may share the directory
+
+    struct session_file_header h;
+    if (pread(fd, &h, sizeof(h), 0) != sizeof(h) || h.magic != SESSION_MAGIC || h.capacity != SESSION_HISTORY) {
+        h.magic = SESSION_MAGIC; // New or unreadable: start the history over
+        h.capacity = SESSION_HISTORY;
+        h.total = 0;
+    }
+
+    off_t slot = sizeof(h) + (off_t)(h.total % h.capacity) * sizeof(rec);
+    if (pwrite(fd, &rec, sizeof(rec), slot) == sizeof(rec)) {
+        h.total++;
+        pwrite(fd, &h, sizeof(h), 0);
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+
+int session_load(struct session_record **out) {
+    *out = NULL;
+    int fd = open(SESSION_FILE, O_RDONLY);
+    if (fd < 0) return 0;
+    flock(fd, LOCK_SH);
+
+    struct session_file_header h;
+    int count = 0;
+    if (pread(fd, &h, sizeof(h), 0) == sizeof(h) && h.magic == SESSION_MAGIC && h.capacity == SESSION_HISTORY) {
+        count = h.total < h.capacity ? (int)h.total : (int)h.capacity;
+        *out = malloc(sizeof(struct session_record) * (count ? count : 1));
+        int first = h.total < h.capacity ? 0 : (int)(h.total % h.capacity); // Oldest record
+        for (int i = 0; *out && i < count; i++) {
+            off_t slot = sizeof(h) + (off_t)((first + i) % h.capacity) * sizeof(struct session_record);
+            if (pread(fd, &(*out)[i], sizeof(struct session_record), slot) != sizeof(struct session_record)) {
+                count = i;
+                break;
+            }
+        }
+        if (!*out) count = 0;
+    }
+
+    flock(fd, LOCK_UN);
+    close(fd);
+    return count;
+}
@@ -0,0 +1,54 @@
+#ifndef SESSION_STATS_H
+#define SESSION_STATS_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+// Rolling history of game sessions, kept in the console's working directory
+#define SESSION_FILE "sessions.vgc"
+#define SESSION_HISTORY 1024 // Records kept; the oldest is overwritten first
+
+// One finished session, 64 bytes on disk
+struct session_record {
+    char game[16];
+    uint32_t start;              // Unix time the game was launched
+    uint32_t wall_ms;            // Launch to exit, suspended time included
+    uint32_t active_ms;          // Time the game had the terminal
+    uint32_t user_ms, sys_ms;    // From wait4()
+    uint32_t max_rss_kb;         // From wait4()
+    uint32_t mean_rss_kb;        // Sampled from /proc while it ran
+    uint32_t peak_cpu_permille;  // Busiest sampling interval, 1000 = one full CPU
+    uint32_t voluntary_switches, involuntary_switches;
+    int32_t exit_status;         // Exit code, or minus the signal that ended it
+    uint32_t reserved;
+};
+
+// Live accounting for one game between launch and exit
+struct session_sampler {
+    long long start_us;
+    long long resumed_us;        // When it last took the terminal, 0 while parked
+    long long active_us;
+    long long last_sample_us;
+    unsigned long long last_cpu_ticks;
+    unsigned long long rss_kb_sum;
+    long samples;
+    uint32_t peak_cpu_permille;
+};
+
+void session_begin(struct session_sampler *s);
+
+// Bracket the time a game has the terminal
+void session_resume(struct session_sampler *s);
+void session_pause(struct session_sampler *s);
+
+// Read /proc/<pid>/stat; cheap to call often, samples at most once per interval
+void session_sample(struct session_sampler *s, pid_t pid);
+
+// Append the finished session to the history file
+void session_end(struct session_sampler *s, const char *game, int status, const struct rusage *usage);
+
+// Read the history, oldest first. Returns the count (0 without a file); free *out.
+int session_load(struct session_record **out);
+
+#endif
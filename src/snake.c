@@ -1,24 +1,53 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
 #include <signal.h>
 #include <time.h>
 #include <sys/select.h>
-#define ROWS 15
+#include "highscore.h"
+#include "rng.h"
+#include "perf_profile.h"
+#include "game_status.h"
+#include "level.h"
+#include "rt_mode.h"
+#include "render.h"
+#include "frame_ring.h"
+#define ROWS 15 // Board used when no --level is given
 #define COLS 15
+#define SCREEN_LINES 20   // Screen area the board is drawn in, in characters
+#define SCREEN_COLUMNS 60
+#define TICK_NS 100000000LL
 
-char grid[ROWS][COLS];
-int snake_head_x = ROWS / 2, snake_head_y = COLS / 2;
+struct level level;
+char score_table[64] = "snake"; // Leaderboard name; each level file gets its own
+int rows, cols;
+char *grid; // rows * cols cells: '.', '+' wall, 'X' bait, 'O' head, '#' body
+#define CELL(x, y) grid[(size_t)(x) * cols + (y)]
+
+int view_rows, view_cols; // Cells shown around the head; more in the denser render modes
+int snake_head_x, snake_head_y;
 int bait_x, bait_y;
 int snake_length = 1;
+uint64_t free_cells; // Cells still '.', so bait placement knows when the board is full
+int board_full = 0;  // The snake covers every free cell: no bait can be placed
+
+// Body cells in a ring buffer, newest first, so a move only touches both ends
 int *snake_tail_x, *snake_tail_y;
+int tail_start = 0, tail_capacity = 0;
+#define TAIL(i) ((tail_start + (i)) & (tail_capacity - 1))
+
+struct rng rng;
 
 struct termios orig_termios;
+int terminal_restored = 0;
 
 // Function to reset terminal on exit
 void reset_terminal() {
+    if (terminal_restored) return; // Already done; clearing again would wipe the exit summary
+    terminal_restored = 1;
     tcsetattr(STDIN_FILENO, TCSANOW, &orig_termios);
     system("clear");
 }
@@ -28,7 +57,17 @@ void handle_signal(int sig) {
     free(snake_tail_x);
     free(snake_tail_y);
     reset_terminal();
-    printf("\nGame exited gracefully.\n");
+    printf("\nGame exited gracefully. Final length: %d\n", snake_length);
+    if (board_full) {
+        printf("The snake fills the whole board!\n");
+    }
+    int placed = hs_submit(score_table, snake_length);
+    if (placed == 2) {
+        printf("New high score!\n");
+    } else if (placed == 1) {
+        printf("Made the top %d!\n", HS_TOP_K);
+    }
+    printf("Seed: %llu (replay with --seed)\n", (unsigned long long)rng.seed);
     exit(0);
 }
 
@@ -55,116 +94,277 @@ int kbhit() {
     return FD_ISSET(STDIN_FILENO, &fds);
 }
 
-// Place bait at a random location
-void place_bait() {
-    do {
-        bait_x = rand() % ROWS;
-        bait_y = rand() % COLS;
-    } while (grid[bait_x][bait_y] != '.');   // avoid placing bait on the snake
-    grid[bait_x][bait_y] = 'X';
+// Write a cell during play, keeping free_cells in step with the '.' cells
+void set_cell(int x, int y, char c) {
+    char old = CELL(x, y);
+    if (old == '.' && c != '.') free_cells--;
+    if (old != '.' && c == '.') free_cells++;
+    CELL(x, y) = c;
 }
 
-// Initialize grid
-void initialize_grid() {
-    for (int i = 0; i < ROWS; i++) {
-        for (int j = 0; j < COLS; j++) {
-            grid[i][j] = '.';
+// Place bait at a random location; sets board_full when there is no free cell left
+void place_bait() {
+    uint64_t total = (uint64_t)rows * cols;
+    if (free_cells == 0) {
+        board_full = 1;
+        return;
+    }
+
+    uint64_t cell = rng_next(&rng) % total; // One draw per attempt
+    if (free_cells * 64 >= total) {
+        // avoid placing bait on the snake or a wall; the scan below catches an unlucky run
+        for (int tries = 0; tries < 1024 && grid[cell] != '.'; tries++) cell = rng_next(&rng) % total;
+    }
+    // Nearly full: scan instead of guessing, stopping after one pass over the board
+    for (uint64_t scanned = 0; grid[cell] != '.'; scanned++) {
+        if (scanned == total) {
+            board_full = 1;
+            return;
         }
+        cell = cell + 1 == total ? 0 : cell + 1;
     }
-    grid[snake_head_x][snake_head_y] = 'O';
+    bait_x = cell / cols;
+    bait_y = cell % cols;
+    set_cell(bait_x, bait_y, 'X');
+}
 
-    // Dynamically allocate memory for snake tail
-    snake_tail_x = malloc(sizeof(int) * ROWS * COLS);
-    snake_tail_y = malloc(sizeof(int) * ROWS * COLS);
-    if (!snake_tail_x || !snake_tail_y) {
+// Double the body ring, unrolling it so the newest cell is at index 0 again
+void grow_tail() {
+    int capacity = tail_capacity ? tail_capacity * 2 : 64;
+    int *new_x = malloc(sizeof(int) * capacity);
+    int *new_y = malloc(sizeof(int) * capacity);
+    if (!new_x || !new_y) {
         perror("Memory allocation failed");
         exit(1);
     }
+    for (int i = 0; i < snake_length - 1; i++) {
+        new_x[i] = snake_tail_x[TAIL(i)];
+        new_y[i] = snake_tail_y[TAIL(i)];
+    }
+    free(snake_tail_x);
+    free(snake_tail_y);
+    snake_tail_x = new_x;
+    snake_tail_y = new_y;
+    tail_start = 0;
+    tail_capacity = capacity;
+}
+
+// Initialize grid from the level's wall bitmap
+void initialize_grid() {
+    rows = level.rows;
+    cols = level.cols;
+    if (!grid) {
+        grid = malloc((size_t)rows * cols);
+        if (!grid) {
+            perror("Memory allocation failed");
+            exit(1);
+        }
+        if (rt_enabled()) rt_prefault(grid, (size_t)rows * cols);
+    }
+    memset(grid, '.', (size_t)rows * cols);
+    free_cells = (uint64_t)rows * cols - 1; // Less the head
+    board_full = 0;
+
+    // Visit only the set bits of each word instead of testing every cell
+    if (level.walls) {
+        for (int i = 0; i < rows; i++) {
+            const uint64_t *row = level.walls + (size_t)i * level.words_per_row;
+            for (uint32_t w = 0; w < level.words_per_row; w++) {
+                for (uint64_t bits = row[w]; bits; bits &= bits - 1) {
+                    CELL(i, w * 64 + __builtin_ctzll(bits)) = '+';
+                    free_cells--;
+                }
+            }
+        }
+    }
+
+    snake_head_x = level.start_row;
+    snake_head_y = level.start_col;
+    CELL(snake_head_x, snake_head_y) = 'O';
+
+    free(snake_tail_x);
+    free(snake_tail_y);
+    snake_tail_x = snake_tail_y = NULL;
+    snake_length = 1;
+    tail_capacity = 0;
+    grow_tail();
+    snake_tail_x[0] = snake_head_x; // The first move clears this cell, so keep it on the grid
+    snake_tail_y[0] = snake_head_y;
 
     place_bait();
 }
 
+// First row and column of the part of the board that is drawn, keeping the head in view
+void view_origin(int *top, int *left, int *height, int *width) {
+    *height = rows < view_rows ? rows : view_rows;
+    *width = cols < view_cols ? cols : view_cols;
+    *top = snake_head_x - *height / 2;
+    *left = snake_head_y - *width / 2;
+    if (*top > rows - *height) *top = rows - *height;
+    if (*left > cols - *width) *left = cols - *width;
+    if (*top < 0) *top = 0;
+    if (*left < 0) *left = 0;
+}
+
 // Display grid
 void display_grid() {
-    system("clear");
-    for (int i = 0; i < ROWS; i++) {
-        for (int j = 0; j < COLS; j++) {
-            printf("%c ", grid[i][j]);
-        }
-        printf("\n");
-    }
+    int top, left, height, width;
+    view_origin(&top, &left, &height, &width);
+
+    char footer[32];
+    snprintf(footer, sizeof(footer), "Length: %d\n", snake_length);
+    render_frame(&CELL(top, left), height, width, cols, footer);
 }
 
-// Move the snake
-void move_snake(char direction) {
-    int new_head_x = snake_head_x;
-    int new_head_y = snake_head_y;
+// Move the snake; returns 0 if the move was blocked
+int move_snake(char direction) {
+    uint32_t new_head_x, new_head_y;
 
-    // Calculate new head position based on the direction
-    switch (direction) {
-        case 'w': new_head_x--; break;
-        case 'a': new_head_y--; break;
-        case 's': new_head_x++; break;
-        case 'd': new_head_y++; break;
+    // Next cell after edges, wrap-around and portals; walls and edges block the move
+    if (!level_step(&level, snake_head_x, snake_head_y, direction, &new_head_x, &new_head_y)) {
+        return 0; // Do not update the snake's position
     }
 
-    // Check for border collision
-    if (new_head_x < 0 || new_head_x >= ROWS || new_head_y < 0 || new_head_y >= COLS) {
-        return; // Do not update the snake's position
-    }
-
-    // Check for self-collision
-    for (int i = 0; i < snake_length; i++) {
-        if (snake_tail_x[i] == new_head_x && snake_tail_y[i] == new_head_y) {
-            return; // Do not update the snake's position
-        }
+    // Check for self-collision: body cells are marked on the grid
+    if (CELL(new_head_x, new_head_y) == '#') {
+        return 0; // Do not update the snake's position
     }
 
     // Check if the snake eats the bait
-    if (new_head_x == bait_x && new_head_y == bait_y) {
+    if (new_head_x == (uint32_t)bait_x && new_head_y == (uint32_t)bait_y) {
         snake_length++; // Grow the snake
+        if (snake_length > tail_capacity) grow_tail();
+        set_cell(new_head_x, new_head_y, 'O'); // Keep the new bait off the head
         place_bait();   // Generate a new bait
     } else {
         // Clear the last tail position
-        grid[snake_tail_x[snake_length - 1]][snake_tail_y[snake_length - 1]] = '.';
+        set_cell(snake_tail_x[TAIL(snake_length - 1)], snake_tail_y[TAIL(snake_length - 1)], '.');
     }
 
-    
-    // Shift body positions
-    for (int i = snake_length - 1; i > 0; i--) {
-        snake_tail_x[i] = snake_tail_x[i - 1];
-        snake_tail_y[i] = snake_tail_y[i - 1];
-    }
-
-    // Update the head position
-    snake_tail_x[0] = snake_head_x;
-    snake_tail_y[0] = snake_head_y;
+    // The old head becomes the newest body cell
+    tail_start = (tail_start - 1) & (tail_capacity - 1);
+    snake_tail_x[tail_start] = snake_head_x;
+    snake_tail_y[tail_start] = snake_head_y;
+    set_cell(snake_head_x, snake_head_y, '#'); // On the first move this is the cell just cleared
 
     snake_head_x = new_head_x;
     snake_head_y = new_head_y;
+    set_cell(snake_head_x, snake_head_y, 'O');
+    return 1;
+}
 
-    // Update the grid
-    grid[snake_head_x][snake_head_y] = 'O';
+// Pick an autoplay direction: the free neighbouring cell closest to the bait, 0 if boxed in
+char autoplay_direction() {
+    static const char dirs[] = {'w', 'a', 's', 'd'};
+    char best = 0;
+    int best_dist = rows + cols;
 
-    for (int i = 0; i < snake_length; i++) {
-        grid[snake_tail_x[i]][snake_tail_y[i]] = '#';
+    for (int d = 0; d < 4; d++) {
+        uint32_t x, y;
+        if (!level_step(&level, snake_head_x, snake_head_y, dirs[d], &x, &y) || CELL(x, y) == '#') continue;
+        int dist = abs((int)x - bait_x) + abs((int)y - bait_y);
+        if (dist < best_dist) {
+            best = dirs[d];
+            best_dist = dist;
+        }
     }
+    return best;
+}
+
+// Run headless with autoplay, writing compact frames for the main menu preview
+void run_preview() {
+    initialize_grid();
+
+    while (1) {
+        char direction = autoplay_direction();
+        if (!direction || !move_snake(direction) || board_full) { // Boxed in or board filled: start over
+            initialize_grid();
+        }
+
+        // One line per row, a blank line ends the frame
+        int top, left, height, width;
+        view_origin(&top, &left, &height, &width);
+        for (int i = top; i < top + height; i++) {
+            fwrite(&CELL(i, left), 1, width, stdout);
+            putchar('\n');
+        }
+        printf("Length: %d\n\n", snake_length);
+        fflush(stdout);
 
-    // grid[snake_tail_x[snake_length - 1]][snake_tail_y[snake_length - 1]] = '.';
+        usleep(100000);
+    }
 }
 
 // Main function
-int main() {
+int main(int argc, char *argv[]) {
     char direction = 'w';
+    const char *level_path = NULL;
+    int render_mode = RENDER_TEXT;
+    int color = 0;
+
+    rng_seed(&rng, rng_seed_from_args(argc, argv));
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--level") == 0) {
+            level_path = argv[i + 1];
+        }
+        if (i + 1 < argc && strcmp(argv[i], "--render") == 0) {
+            render_mode = render_parse_mode(argv[i + 1]);
+        }
+        if (strcmp(argv[i], "--color") == 0) {
+            color = 1;
+        }
+    }
+    if (render_mode < 0) {
+        fprintf(stderr, "Render modes are text, half and braille\n");
+        exit(1);
+    }
+    render_init(render_mode, color);
+    render_palette('+', 244); // Walls
+    render_palette('#', 40);  // Body
+    render_palette('X', 196); // Bait
+    render_palette('O', 226); // Head
+    render_view_size(SCREEN_LINES, SCREEN_COLUMNS, &view_rows, &view_cols);
+
+    if (level_path) {
+        if (level_load(&level, level_path) < 0) exit(1);
+        // Lengths on different boards do not compare, so keep them off the classic table
+        const char *base = strrchr(level_path, '/');
+        snprintf(score_table, sizeof(score_table), "snake:%s", base ? base + 1 : level_path);
+    } else {
+        level_blank(&level, ROWS, COLS);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--preview") == 0) {
+            run_preview();
+        }
+        if (strcmp(argv[i], "--profile") == 0) {
+            prof_open();
+        }
+        if (strcmp(argv[i], "--rt") == 0) {
+            rt_open();
+            jitter_open();
+        }
+        if (strcmp(argv[i], "--jitter") == 0) {
+            jitter_open();
+        }
+    }
 
     printf("%c]0;%s%c", '\033', "snake", '\007');
 
-    srand(time(NULL));
+    rng_log_seed("snake", rng.seed);
+    hs_open(1); // Scores are simply not kept if the leaderboard is unavailable
     setup_terminal();
+    game_status_attach();
+    frame_ring_open("snake");
     initialize_grid();
+    render_prepare(rows < view_rows ? rows : view_rows, cols < view_cols ? cols : view_cols);
+    rt_lock_memory();
 
     while (1) {
+        prof_begin(PROF_RENDER);
         display_grid();
+        prof_end(PROF_RENDER);
 
         if (kbhit()) {
             char input = getchar();
@@ -174,8 +374,12 @@ int main() {
             }
         }
 
+        prof_begin(PROF_SIMULATE);
         move_snake(direction);
-        usleep(100000); // Slow down the game loop
+        prof_end(PROF_SIMULATE);
+        if (board_full) break;
+        game_status_beat(snake_length);
+        rt_tick_wait(TICK_NS); // Slow down the game loop
     }
 
     handle_signal(0);
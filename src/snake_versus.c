@@ -0,0 +1,580 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <termios.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "rng.h"
+#include "game_status.h"
+#include "rt_mode.h"
+
+#define ROWS 15
+#define COLS 15
+#define CELLS (ROWS * COLS)
+
+#define TICK_NS 100000000LL   // Same pace as single-player snake
+#define HISTORY 64            // Snapshots and inputs kept, in ticks (power of two)
+#define MAX_PREDICT 30        // Ticks we may run ahead of the last confirmed remote input
+#define SOCKET_PATH "snake_versus.sock"
+#define HELLO_MAGIC 0x56534e4bU  // "VSNK"
+
+enum { RUNNING = -1, DRAW = 2 }; // Otherwise the result is the winning player
+
+enum { MSG_INPUT = 1, MSG_QUIT = 2 };
+
+// Everything a tick depends on lives here, so a snapshot is one memcpy
+struct snake {
+    uint8_t body[CELLS];  // Ring of cell indices, head at body[head]
+    uint16_t head;
+    uint16_t length;
+    char dir;
+    uint8_t alive;
+};
+
+struct game_state {
+    uint32_t tick;        // Ticks simulated so far
+    int8_t result;
+    uint8_t bait;
+    uint8_t occupied[CELLS]; // 0 if free, otherwise owning player + 1
+    struct snake snakes[2];
+    struct rng rng;
+};
+
+// Fixed-size wire messages
+struct hello_msg {
+    uint32_t magic;
+    uint32_t seed_hi;
+    uint32_t seed_lo;
+    uint32_t pad;
+};
+
+struct input_msg {
+    uint32_t tick;
+    char dir;
+    int8_t advantage;     // Sender's ticks ahead of its confirmed input from us
+    uint8_t type;
+    uint8_t pad;
+};
+
+struct game_state state;
+struct game_state history[HISTORY]; // history[t % HISTORY] is the state before tick t
+char inputs[2][HISTORY];            // Direction each player pressed on tick t
+char used_remote[HISTORY];          // Remote direction tick t was last simulated with
+uint32_t remote_confirmed = 0;      // Remote inputs received for ticks [0, remote_confirmed)
+int remote_advantage = 0;
+int peer_gone = 0;                  // The peer closed the connection or the socket failed
+int me, peer;
+int sock = -1;
+int is_unix_host = 0;
+long rollbacks = 0, resimulated = 0, max_rollback = 0;
+
+char out_buf[sizeof(struct input_msg) * HISTORY]; // Messages the socket has not accepted yet
+size_t out_len = 0;
+
+struct termios orig_termios;
+int terminal_restored = 0;
+
+// Reset terminal on exit
+void reset_terminal() {
+    if (terminal_restored) return;
+    terminal_restored = 1;
+    tcsetattr(STDIN_FILENO, TCSANOW, &orig_termios);
+    system("clear");
+}
+
+// Send what the socket accepts now and keep the rest for the next call, so a short
+// write never splits a message and breaks the fixed-size framing
+void flush_output() {
+    while (out_len > 0 && !peer_gone) {
+        ssize_t n = send(sock, out_buf, out_len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) peer_gone = 1;
+            return;
+        }
+        memmove(out_buf, out_buf + n, out_len - n);
+        out_len -= n;
+    }
+}
+
+// Queue a message behind any unsent ones and try to send them
+void queue_message(const struct input_msg *msg) {
+    if (out_len + sizeof(*msg) > sizeof(out_buf)) {
+        peer_gone = 1; // The peer has stopped reading for HISTORY messages
+        return;
+    }
+    memcpy(out_buf + out_len, msg, sizeof(*msg));
+    out_len += sizeof(*msg);
+    flush_output();
+}
+
+// Signal handler for graceful exit
+void handle_signal(int sig) {
+    if (sock >= 0) {
+        struct input_msg msg = {0};
+        msg.type = MSG_QUIT;
+        queue_message(&msg);
+        close(sock);
+    }
+    if (is_unix_host) unlink(SOCKET_PATH);
+    reset_terminal();
+    printf("\nGame exited gracefully.\n");
+    exit(0);
+}
+
+// Set terminal to non-canonical mode for real-time input
+void setup_terminal() {
+    struct termios new_termios;
+    tcgetattr(STDIN_FILENO, &orig_termios);
+    atexit(reset_terminal);
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    new_termios = orig_termios;
+    new_termios.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
+}
+
+// Non-blocking input
+int kbhit() {
+    struct timeval tv = {0, 0};
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(STDIN_FILENO, &fds);
+    select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv);
+    return FD_ISSET(STDIN_FILENO, &fds);
+}
+
+// Place bait on a random free cell, drawing from the state's own generator
+void place_bait(struct game_state *s) {
+    int cell;
+    do {
+        cell = rng_below(&s->rng, CELLS);
+    } while (s->occupied[cell]);
+    s->bait = cell;
+}
+
+void init_state(struct game_state *s, uint64_t seed) {
+    memset(s, 0, sizeof(*s));
+    s->result = RUNNING;
+    rng_seed(&s->rng, seed);
+
+    for (int p = 0; p < 2; p++) {
+        struct snake *sn = &s->snakes[p];
+        // Opposite corners, heading along opposite edges
+        int cell = p == 0 ? 2 * COLS + 2 : (ROWS - 3) * COLS + COLS - 3;
+        sn->body[0] = cell;
+        sn->length = 1;
+        sn->dir = p == 0 ? 'd' : 'a';
+        sn->alive = 1;
+        s->occupied[cell] = p + 1;
+    }
+    place_bait(s);
+}
+
+// Cell the snake's head moves into, or -1 for a wall
+int next_cell(const struct snake *sn) {
+    int cell = sn->body[sn->head];
+    int x = cell / COLS, y = cell % COLS;
+
+    switch (sn->dir) {
+        case 'w': x--; break;
+        case 'a': y--; break;
+        case 's': x++; break;
+        case 'd': y++; break;
+    }
+    if (x < 0 || x >= ROWS || y < 0 || y >= COLS) return -1;
+    return x * COLS + y;
+}
+
+int is_reverse(char a, char b) {
+    return (a == 'w' && b == 's') || (a == 's' && b == 'w') ||
+           (a == 'a' && b == 'd') || (a == 'd' && b == 'a');
+}
+
+// Advance one tick. Pure integer logic on the state, so both sides compute the same result.
+void step(struct game_state *s, char in0, char in1) {
+    char in[2] = {in0, in1};
+    int target[2];
+
+    for (int p = 0; p < 2; p++) {
+        struct snake *sn = &s->snakes[p];
+        if (!is_reverse(sn->dir, in[p])) sn->dir = in[p];
+        target[p] = next_cell(sn);
+    }
+
+    // Crashes are judged against the board before either snake moves
+    int crashed[2];
+    for (int p = 0; p < 2; p++) {
+        crashed[p] = target[p] < 0 || s->occupied[target[p]];
+    }
+    if (target[0] >= 0 && target[0] == target[1]) {
+        crashed[0] = crashed[1] = 1; // Head-on collision
+    }
+
+    int ate = 0;
+    for (int p = 0; p < 2; p++) {
+        struct snake *sn = &s->snakes[p];
+        if (crashed[p]) {
+            sn->alive = 0;
+            continue;
+        }
+
+        if (target[p] == s->bait) {
+            sn->length++;
+            ate = 1;
+        } else {
+            int tail = (sn->head + CELLS - (sn->length - 1)) % CELLS;
+            s->occupied[sn->body[tail]] = 0;
+        }
+        sn->head = (sn->head + 1) % CELLS;
+        sn->body[sn->head] = target[p];
+        s->occupied[target[p]] = p + 1;
+    }
+    if (ate) place_bait(s);
+
+    if (!s->snakes[0].alive || !s->snakes[1].alive) {
+        if (s->snakes[0].alive) s->result = 0;
+        else if (s->snakes[1].alive) s->result = 1;
+        else s->result = DRAW;
+    }
+    s->tick++;
+}
+
+// Direction a player used on tick t: real when known, otherwise the last confirmed one repeated
+char input_for(int player, uint32_t t) {
+    if (player == me || t < remote_confirmed) return inputs[player][t % HISTORY];
+    if (remote_confirmed == 0) return peer == 0 ? 'd' : 'a';
+    return inputs[player][(remote_confirmed - 1) % HISTORY];
+}
+
+// Run tick t from the current state, remembering the prediction it used
+void simulate_tick(uint32_t t) {
+    history[t % HISTORY] = state;
+    used_remote[t % HISTORY] = input_for(peer, t);
+    step(&state, input_for(0, t), input_for(1, t));
+}
+
+void send_input(uint32_t tick, char dir, int advantage) {
+    struct input_msg msg = {htonl(tick), dir, (int8_t)advantage, MSG_INPUT, 0};
+    queue_message(&msg);
+}
+
+// Apply every input the peer has sent; returns the earliest mispredicted tick, or -1
+long receive_inputs() {
+    static char buf[sizeof(struct input_msg) * 64];
+    static size_t have = 0;
+    long rollback_to = -1;
+
+    while (1) {
+        ssize_t n = recv(sock, buf + have, sizeof(buf) - have, 0);
+        if (n == 0) {
+            peer_gone = 1; // Its final inputs are already applied; the caller decides what that means
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) peer_gone = 1; // e.g. ECONNRESET from a crashed peer
+            break; // EAGAIN: nothing more for now
+        }
+        have += n;
+
+        size_t used = 0;
+        while (have - used >= sizeof(struct input_msg)) {
+            struct input_msg msg;
+            memcpy(&msg, buf + used, sizeof(msg));
+            used += sizeof(msg);
+
+            if (msg.type == MSG_QUIT) {
+                reset_terminal();
+                printf("\nOpponent quit.\n");
+                exit(0);
+            }
+
+            uint32_t t = ntohl(msg.tick);
+            inputs[peer][t % HISTORY] = msg.dir;
+            remote_confirmed = t + 1; // The stream is ordered, so inputs arrive contiguously
+            remote_advantage = msg.advantage;
+
+            if (t < state.tick && used_remote[t % HISTORY] != msg.dir && rollback_to < 0) {
+                rollback_to = t;
+            }
+        }
+        memmove(buf, buf + used, have - used);
+        have -= used;
+    }
+    return rollback_to;
+}
+
+// Rewind to the snapshot before tick t and replay up to the present with corrected inputs
+void rollback(uint32_t t) {
+    uint32_t present = state.tick;
+
+    state = history[t % HISTORY];
+    for (uint32_t i = t; i < present; i++) {
+        simulate_tick(i);
+    }
+
+    rollbacks++;
+    resimulated += present - t;
+    if ((long)(present - t) > max_rollback) max_rollback = present - t;
+}
+
+// Display grid
+void display_grid() {
+    static const char head_glyph[2] = {'O', '@'};
+    static const char body_glyph[2] = {'#', '*'};
+    char grid[CELLS];
+
+    memset(grid, '.', sizeof(grid));
+    grid[state.bait] = 'X';
+    for (int p = 0; p < 2; p++) {
+        const struct snake *sn = &state.snakes[p];
+        for (int i = 0; i < sn->length; i++) {
+            grid[sn->body[(sn->head + CELLS - i) % CELLS]] = i == 0 ? head_glyph[p] : body_glyph[p];
+        }
+    }
+
+    printf("\033[H\033[J");
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            printf("%c ", grid[i * COLS + j]);
+        }
+        printf("\n");
+    }
+    printf("You (%c): length %d   Opponent (%c): length %d\n", head_glyph[me],
+           state.snakes[me].length, head_glyph[peer], state.snakes[peer].length);
+    printf("Tick %u, %u ahead of confirmed input\n", state.tick, state.tick - remote_confirmed);
+    printf("Use 'w', 'a', 's', 'd' to steer, 'q' to quit.\n");
+    fflush(stdout);
+}
+
+// Resolve host:port and connect over TCP
+int connect_tcp(const char *address) {
+    char host[256];
+    const char *colon = strrchr(address, ':');
+    if (!colon) {
+        fprintf(stderr, "Expected HOST:PORT, got %s\n", address);
+        exit(1);
+    }
+    snprintf(host, sizeof(host), "%.*s", (int)(colon - address), address);
+
+    struct addrinfo hints = {0}, *res;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, colon + 1, &hints, &res) != 0) {
+        fprintf(stderr, "Unable to resolve %s\n", address);
+        exit(1);
+    }
+
+    int fd = socket(res->ai_family, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        perror("Unable to connect");
+        exit(1);
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// Wait for the opponent on a listening socket; 'q' cancels
+int accept_peer(int listen_fd) {
+    printf("Waiting for an opponent... (press 'q' to cancel)\n");
+
+    while (1) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(STDIN_FILENO, &fds);
+        FD_SET(listen_fd, &fds);
+        if (select(listen_fd + 1, &fds, NULL, NULL, NULL) < 0) continue;
+
+        if (FD_ISSET(STDIN_FILENO, &fds) && getchar() == 'q') {
+            close(listen_fd);
+            handle_signal(0);
+        }
+        if (FD_ISSET(listen_fd, &fds)) {
+            int fd = accept(listen_fd, NULL, NULL);
+            if (fd >= 0) {
+                close(listen_fd);
+                return fd;
+            }
+        }
+    }
+}
+
+int listen_tcp(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        perror("Unable to listen");
+        exit(1);
+    }
+    return accept_peer(fd);
+}
+
+// Join a game waiting on the local socket, or start one if nobody is waiting
+int pair_unix(int *is_host) {
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", SOCKET_PATH);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        *is_host = 0;
+        return fd;
+    }
+
+    unlink(SOCKET_PATH); // Left behind by a game that did not exit cleanly
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        perror("Unable to listen");
+        exit(1);
+    }
+    *is_host = 1;
+    is_unix_host = 1;
+    return accept_peer(fd);
+}
+
+// Read exactly len bytes from a blocking socket
+void read_full(int fd, void *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(fd, (char *)buf + got, len - got, 0);
+        if (n <= 0) {
+            reset_terminal();
+            printf("\nConnection lost during handshake.\n");
+            exit(1);
+        }
+        got += n;
+    }
+}
+
+// Main function
+int main(int argc, char *argv[]) {
+    const char *join_address = NULL;
+    int host_port = 0;
+    int is_host = 0;
+    uint64_t seed = rng_seed_from_args(argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--preview") == 0) {
+            return 0; // Needs an opponent, so there is nothing to preview
+        }
+        if (strcmp(argv[i], "--rt") == 0) {
+            rt_open();
+            jitter_open();
+        }
+        if (strcmp(argv[i], "--jitter") == 0) {
+            jitter_open();
+        }
+        if (i + 1 < argc && strcmp(argv[i], "--host") == 0) host_port = atoi(argv[i + 1]);
+        if (i + 1 < argc && strcmp(argv[i], "--join") == 0) join_address = argv[i + 1];
+    }
+
+    printf("%c]0;%s%c", '\033', "snake_versus", '\007');
+    setup_terminal();
+
+    if (host_port) {
+        sock = listen_tcp(host_port);
+        is_host = 1;
+    } else if (join_address) {
+        sock = connect_tcp(join_address);
+    } else {
+        sock = pair_unix(&is_host);
+    }
+
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Fails harmlessly on Unix sockets
+
+    // The host picks the seed so both sides build the same initial state
+    struct hello_msg hello;
+    if (is_host) {
+        hello.magic = htonl(HELLO_MAGIC);
+        hello.seed_hi = htonl((uint32_t)(seed >> 32));
+        hello.seed_lo = htonl((uint32_t)seed);
+        hello.pad = 0;
+        send(sock, &hello, sizeof(hello), MSG_NOSIGNAL);
+    } else {
+        read_full(sock, &hello, sizeof(hello));
+        if (ntohl(hello.magic) != HELLO_MAGIC) {
+            reset_terminal();
+            printf("\nPeer is not a snake_versus game.\n");
+            exit(1);
+        }
+        seed = ((uint64_t)ntohl(hello.seed_hi) << 32) | ntohl(hello.seed_lo);
+    }
+    rng_log_seed("snake_versus", seed);
+    fcntl(sock, F_SETFL, O_NONBLOCK);
+
+    me = is_host ? 0 : 1;
+    peer = 1 - me;
+    init_state(&state, seed);
+    game_status_attach();
+    rt_lock_memory();
+    char local_dir = state.snakes[me].dir;
+
+    while (1) {
+        while (kbhit()) {
+            char input = getchar();
+            if (input == 'q') handle_signal(0);
+            if (input == 'w' || input == 'a' || input == 's' || input == 'd') {
+                local_dir = input;
+            }
+        }
+
+        flush_output(); // Anything a full socket buffer held back last tick
+        long rollback_to = receive_inputs();
+        if (rollback_to >= 0) rollback(rollback_to);
+
+        // A result only counts once every input that led to it is confirmed
+        if (state.result != RUNNING && state.tick <= remote_confirmed) break;
+        if (peer_gone) {
+            reset_terminal();
+            printf("\nOpponent disconnected.\n");
+            exit(0);
+        }
+
+        int advantage = state.tick - remote_confirmed;
+        // Let the side that is further ahead wait a tick, so prediction is shared evenly
+        int balance = advantage - remote_advantage >= 2;
+
+        if (state.result == RUNNING && advantage < MAX_PREDICT && !balance) {
+            uint32_t t = state.tick;
+            inputs[me][t % HISTORY] = local_dir;
+            send_input(t, local_dir, advantage);
+            simulate_tick(t);
+        }
+
+        display_grid();
+        game_status_beat(state.snakes[me].length);
+
+        rt_tick_wait(TICK_NS);
+    }
+
+    display_grid();
+    if (is_unix_host) unlink(SOCKET_PATH);
+    reset_terminal();
+    if (state.result == DRAW) {
+        printf("\nDraw!\n");
+    } else {
+        printf("\n%s\n", state.result == me ? "You win!" : "You lose!");
+    }
+    printf("Rollbacks: %ld (max depth %ld, %ld ticks resimulated)\n", rollbacks, max_rollback, resimulated);
+    close(sock);
+    return 0;
+}
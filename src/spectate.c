@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include "frame_ring.h"
+
+#define SHM_DIR "/dev/shm"
+#define POLL_US 10000
+
+volatile sig_atomic_t stop = 0;
+
+// Signal handler: leave the watch loop and restore the terminal there
+void handle_signal(int sig) {
+    stop = 1;
+}
+
+int publisher_alive(const struct frame_ring *ring) {
+    return !atomic_load(&ring->closed) && (kill(ring->publisher_pid, 0) == 0 || errno != ESRCH);
+}
+
+// List live broadcasts; rings left behind by a killed game are removed. With a
+// game name, store the newest broadcast of that game in match instead.
+int scan_broadcasts(const char *game, char *match, size_t match_size) {
+    DIR *dp = opendir(SHM_DIR);
+    if (!dp) {
+        perror("Unable to open " SHM_DIR);
+        exit(1);
+    }
+
+    int found = 0;
+    int newest_pid = -1;
+    struct dirent *entry;
+    while ((entry = readdir(dp))) {
+        if (strncmp(entry->d_name, FRAME_RING_PREFIX, strlen(FRAME_RING_PREFIX)) != 0) continue;
+
+        const struct frame_ring *ring = frame_ring_attach(entry->d_name);
+        if (!ring) continue;
+        int alive = publisher_alive(ring);
+        int pid = ring->publisher_pid;
+        munmap((void *)ring, sizeof(struct frame_ring));
+
+        if (!alive) {
+            char path[300];
+            snprintf(path, sizeof(path), "/%s", entry->d_name);
+            shm_unlink(path);
+            continue;
+        }
+
+        const char *name = entry->d_name + strlen(FRAME_RING_PREFIX);
+        if (!game) {
+            printf("  %s\n", name);
+            found++;
+        } else if (strcmp(name, game) == 0 ||
+                   (strncmp(name, game, strlen(game)) == 0 && name[strlen(game)] == '-' && pid > newest_pid)) {
+            snprintf(match, match_size, "%s", entry->d_name);
+            newest_pid = strcmp(name, game) == 0 ? 1 << 30 : pid; // An exact name always wins
+            found++;
+        }
+    }
+    closedir(dp);
+    return found;
+}
+
+// Show the newest frame whenever the game publishes one
+void watch(const struct frame_ring *ring) {
+    static char frame[FRAME_RING_SLOT_SIZE];
+    uint64_t shown = 0, frames = 0, skipped = 0;
+
+    printf("\033[2J\033[H");
+    fflush(stdout);
+
+    while (!stop) {
+        uint64_t head = atomic_load(&ring->head);
+        if (head != 0 && head != shown) {
+            long len = frame_ring_read(ring, head, frame);
+            if (len < 0) continue; // Overwritten while copying: take the newer frame at once
+
+            if (shown != 0) skipped += head - shown - 1;
+            shown = head;
+            frames++;
+            for (long done = 0; done < len;) {
+                ssize_t n = write(STDOUT_FILENO, frame + done, len - done);
+                if (n < 0 && errno != EINTR) break;
+                if (n > 0) done += n;
+            }
+        }
+
+        if (!publisher_alive(ring)) break;
+        usleep(POLL_US);
+    }
+
+    printf("\033[0m\n%s (%llu frames shown, %llu skipped)\n", stop ? "Stopped watching" : "The game has ended",
+           (unsigned long long)frames, (unsigned long long)skipped);
+}
+
+// Main function
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("Running games:\n");
+        if (scan_broadcasts(NULL, NULL, 0) == 0) printf("  none\n");
+        printf("Usage: %s GAME or %s GAME-PID\n", argv[0], argv[0]);
+        return 0;
+    }
+
+    char name[300];
+    if (scan_broadcasts(argv[1], name, sizeof(name)) == 0) {
+        fprintf(stderr, "No running game matches %s\n", argv[1]);
+        return 1;
+    }
+
+    const struct frame_ring *ring = frame_ring_attach(name);
+    if (!ring) {
+        fprintf(stderr, "Unable to attach to %s\n", name);
+        return 1;
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+    printf("%c]0;%s%c", '\033', "spectate", '\007');
+    watch(ring);
+    return 0;
+}
@@ -1,8 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>  // For read()
 #include <termios.h> // For terminal settings
 #include <ctype.h>   // For tolower()
+#include <signal.h>  // For redrawing on SIGCONT
+#include <errno.h>   // For EINTR
+#include "rng.h"
+#include "perf_profile.h"
+#include "game_status.h"
+#include "rt_mode.h"
 
 // Function Prototypes
 void display_board();
@@ -12,26 +19,62 @@ void reset_game();
 void setup_terminal();
 void reset_terminal();
 void display_game_over_screen(int result);
+void draw_game_over_screen(int result);
+void run_preview(uint64_t seed);
+void handle_continue(int sig);
 
 // Global variables
 char board[3][3];
 char current_player = 'X';
 struct termios orig_termios;
+volatile sig_atomic_t resumed = 0; // Set on SIGCONT; the screen is redrawn outside the handler
 
-int main() {
+int main(int argc, char *argv[]) {
     int game_over = 0;
 
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--preview") == 0) {
+            run_preview(rng_seed_from_args(argc, argv));
+        }
+        if (strcmp(argv[i], "--profile") == 0) {
+            prof_open();
+        }
+        if (strcmp(argv[i], "--rt") == 0) {
+            rt_open();
+            jitter_open();
+        }
+        if (strcmp(argv[i], "--jitter") == 0) {
+            jitter_open();
+        }
+    }
+
     printf("%c]0;%s%c", '\033', "tic_tac_toe", '\007');
 
     printf("Welcome to Tic Tac Toe!\n");
     reset_game();
     setup_terminal();
+    game_status_attach();
+    rt_lock_memory();
+
+    // No SA_RESTART, so a blocking read() returns EINTR and the board can be redrawn
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_continue;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGCONT, &sa, NULL);
 
     while (!game_over) {
+        prof_begin(PROF_RENDER);
         display_board();
+        prof_end(PROF_RENDER);
+
+        game_status_beat(0);
+        game_status_set_state(GS_WAITING_INPUT); // Blocking on a move is not a hang
         player_move();
 
+        prof_begin(PROF_SIMULATE);
         game_over = check_winner();
+        prof_end(PROF_SIMULATE);
 
         if (game_over == 1 || game_over == -1) {
             display_game_over_screen(game_over);
@@ -46,6 +89,11 @@ int main() {
     return 0;
 }
 
+// Function to note a resume from the main menu; only async-signal-safe work here
+void handle_continue(int sig) {
+    resumed = 1;
+}
+
 // Function to reset the game board
 void reset_game() {
     for (int i = 0; i < 3; i++) {
@@ -72,8 +120,56 @@ void display_board() {
     printf("Enter your move (1-9) or 'q' to quit: \n");
 }
 
-// Function to display game over screen
-void display_game_over_screen(int result) {
+// Function to play random moves headless, writing compact frames for the main menu preview
+void run_preview(uint64_t seed) {
+    struct rng rng;
+    int ticks_left = 0; // Frames left to show the current board
+    int game_over = 0;
+
+    rng_seed(&rng, seed);
+    reset_game();
+
+    while (1) {
+        if (ticks_left == 0) {
+            if (game_over) {
+                reset_game();
+                current_player = 'X';
+                game_over = 0;
+            } else {
+                // Pick a random free cell
+                int free_cells[9];
+                int n = 0;
+                for (int i = 0; i < 9; i++) {
+                    char c = board[i / 3][i % 3];
+                    if (c != 'X' && c != 'O') free_cells[n++] = i;
+                }
+                int move = free_cells[rng_below(&rng, n)];
+                board[move / 3][move % 3] = current_player;
+
+                game_over = check_winner();
+                current_player = (current_player == 'X') ? 'O' : 'X';
+            }
+            ticks_left = game_over ? 15 : 5; // Linger on finished boards
+        }
+        ticks_left--;
+
+        // One line per row, a blank line ends the frame
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                char c = board[i][j];
+                printf(" %c", (c == 'X' || c == 'O') ? c : '.');
+            }
+            printf("\n");
+        }
+        printf("\n");
+        fflush(stdout);
+
+        usleep(100000);
+    }
+}
+
+// Function to draw the game over screen
+void draw_game_over_screen(int result) {
     system("clear");
     printf("Game Over\n");
     printf("==========\n\n");
@@ -87,11 +183,21 @@ void display_game_over_screen(int result) {
     }
 
     printf("To exit press 'q'\n");
+}
+
+// Function to display game over screen
+void display_game_over_screen(int result) {
+    draw_game_over_screen(result);
 
     // Wait for 'q' to exit
     char input;
     while (1) {
+        if (resumed) {
+            resumed = 0;
+            draw_game_over_screen(result);
+        }
         if (read(STDIN_FILENO, &input, 1) == -1) {
+            if (errno == EINTR) continue;
             perror("Error reading input");
             exit(1);
         }
@@ -137,9 +243,15 @@ void player_move() {
     int valid_move = 0;
 
     while (!valid_move) {
+        // Redraw after a resume from the main menu
+        if (resumed) {
+            resumed = 0;
+            display_board();
+        }
 
         // Use read to get immediate input
         if (read(STDIN_FILENO, &input, 1) == -1) {
+            if (errno == EINTR) continue;
             perror("Error reading input");
             exit(1);
         }
@@ -32,10 +32,14 @@ else
     sudo mount $LOOP_DEVICE $MOUNT_DIR
 fi
 
-sudo gcc -o mount/game_snake src/snake.c
-sudo gcc -o mount/game_tic_tac_toe src/tic_tac_toe.c
-sudo gcc -o mount/game_avoid_blocks src/avoid_blocks.c
-sudo gcc -o mount/main_screen src/main_screen.c
+sudo gcc -o mount/game_snake src/snake.c src/level.c src/highscore.c src/rng.c src/perf_profile.c src/game_status.c src/rt_mode.c src/render.c src/frame_ring.c
+sudo gcc -o mount/game_tic_tac_toe src/tic_tac_toe.c src/rng.c src/perf_profile.c src/game_status.c src/rt_mode.c
+sudo gcc -o mount/game_avoid_blocks src/avoid_blocks.c src/block_patterns.c src/highscore.c src/rng.c src/perf_profile.c src/game_status.c src/rt_mode.c src/render.c src/frame_ring.c
+sudo gcc -o mount/game_snake_versus src/snake_versus.c src/rng.c src/game_status.c src/rt_mode.c
+sudo gcc -o mount/main_screen src/main_screen.c src/highscore.c src/game_status.c src/rt_mode.c src/session_stats.c
+sudo gcc -o mount/level_tool src/level_tool.c src/level.c src/rng.c
+sudo gcc -O2 -pthread -o mount/block_analyzer src/block_analyzer.c src/block_patterns.c src/rng.c
+sudo gcc -o mount/spectate src/spectate.c src/frame_ring.c
 
 # add the executables to the mount directory
 